@@ -0,0 +1,63 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_CANCELLATION_TOKEN
+#define LOOT_CANCELLATION_TOKEN
+
+#include <atomic>
+
+namespace loot {
+/**
+ * @brief A flag used to request that an asynchronous operation stops.
+ * @details Operations check the token at regular intervals, and stop by
+ *          throwing an OperationCancelledError. A token can be shared
+ *          between any number of operations, and may be cancelled from any
+ *          thread. Once cancelled, a token cannot be reset.
+ */
+class CancellationToken {
+public:
+  inline CancellationToken() : isCancelled_(false) {}
+
+  CancellationToken(const CancellationToken&) = delete;
+  CancellationToken& operator=(const CancellationToken&) = delete;
+
+  /**
+   * @brief Request that any operations using this token stop.
+   */
+  inline void Cancel() { isCancelled_.store(true, std::memory_order_release); }
+
+  /**
+   * @brief Check if cancellation has been requested.
+   * @returns True if ``Cancel()`` has been called, false otherwise.
+   */
+  inline bool IsCancelled() const {
+    return isCancelled_.load(std::memory_order_acquire);
+  }
+
+private:
+  std::atomic<bool> isCancelled_;
+};
+}
+
+#endif
@@ -60,6 +60,24 @@ public:
   virtual void LoadLists(const std::filesystem::path& masterlist_path,
                          const std::filesystem::path& userlist_path = "") = 0;
 
+  /**
+   *  @brief Set the path of a file used to cache a compiled copy of the
+   *         masterlist.
+   *  @details If a path is set, ``LoadLists()`` reads the masterlist's
+   *           metadata from the cache file instead of parsing the masterlist,
+   *           provided that the cache file was written by the same version of
+   *           libloot from a masterlist with the same size and CRC. Otherwise
+   *           the masterlist is parsed and the cache file is replaced. Plugin
+   *           metadata is read from the cache file as it is needed. If the
+   *           cache file is corrupt, it is ignored and rewritten. Caching is
+   *           disabled by default.
+   *  @param cachePath
+   *         The path of the cache file to use. Its parent directory must
+   *         exist. If empty, the masterlist is not cached.
+   */
+  virtual void SetMasterlistCachePath(
+      const std::filesystem::path& cachePath) = 0;
+
   /**
    * Writes a metadata file containing all loaded user-added metadata.
    * @param outputFile
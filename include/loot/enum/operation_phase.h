@@ -0,0 +1,59 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2012-2016    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_OPERATION_PHASE
+#define LOOT_OPERATION_PHASE
+
+namespace loot {
+/**
+ * @brief Codes used to identify which part of loading or sorting plugins is
+ *        in progress.
+ * @details The sorting phases are listed in the order that they happen, and
+ *          correspond to the durations recorded in SortStatistics.
+ */
+enum struct OperationPhase : unsigned int {
+  /** Plugins are being read and parsed. */
+  load_plugins,
+  /** Plugin and group vertices are being added to the plugin graph. */
+  add_vertices,
+  /** Master flag, master, requirement and load after edges are being
+   *  added. */
+  add_specific_edges,
+  /** Edges for plugins that are hardcoded to load first are being added. */
+  add_hardcoded_edges,
+  /** Edges for plugin groups are being added. */
+  add_group_edges,
+  /** Plugins are being checked for overlapping records. */
+  add_overlap_edges,
+  /** Tie-break edges are being added. This is skipped when using the
+   *  ``SortingEngine::priority`` engine. */
+  add_tie_break_edges,
+  /** The plugin graph is being checked for cycles. */
+  check_for_cycles,
+  /** The plugin graph is being topologically sorted. */
+  topological_sort,
+};
+}
+
+#endif
@@ -0,0 +1,55 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2012-2016    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_SORTING_ENGINE
+#define LOOT_SORTING_ENGINE
+
+/**
+ * The namespace used by libloot.
+ */
+namespace loot {
+/**
+ * @brief Codes used to select how plugins with no ordering constraints
+ *        between them are ordered relative to one another when sorting.
+ */
+enum struct SortingEngine : unsigned int {
+  /**
+   * Add tie-break edges between every pair of unconstrained plugins, then
+   * topologically sort the resulting graph. This is the default, and gives
+   * the same results as previous releases.
+   */
+  compatibility,
+  /**
+   * Topologically sort the plugin graph without tie-break edges, choosing
+   * the highest-priority plugin whenever more than one plugin could load
+   * next. Priority is given by the current load order and then by filename,
+   * as for tie-break edges. This avoids the quadratic cost of adding
+   * tie-break edges, but can give a different order when the current load
+   * order disagrees with the other sorting constraints.
+   */
+  priority,
+};
+}
+
+#endif
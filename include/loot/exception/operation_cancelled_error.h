@@ -0,0 +1,47 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_EXCEPTION_OPERATION_CANCELLED_ERROR
+#define LOOT_EXCEPTION_OPERATION_CANCELLED_ERROR
+
+#include <stdexcept>
+
+#include "loot/api_decorator.h"
+
+namespace loot {
+/**
+ * @brief An exception class thrown if an asynchronous operation stops
+ *        because its cancellation token was cancelled.
+ */
+class OperationCancelledError : public std::runtime_error {
+public:
+  /**
+   * @brief Construct an exception for a cancelled operation.
+   */
+  LOOT_API OperationCancelledError() :
+      std::runtime_error("The operation was cancelled") {}
+};
+}
+
+#endif
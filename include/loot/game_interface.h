@@ -24,10 +24,18 @@
 #ifndef LOOT_GAME_INTERFACE
 #define LOOT_GAME_INTERFACE
 
+#include <filesystem>
+#include <future>
+#include <memory>
 #include <optional>
 
+#include "loot/cancellation_token.h"
 #include "loot/database_interface.h"
+#include "loot/enum/sorting_engine.h"
 #include "loot/plugin_interface.h"
+#include "loot/struct/operation_progress.h"
+#include "loot/struct/plugin_load_result.h"
+#include "loot/struct/sort_statistics.h"
 
 namespace loot {
 /** @brief The interface provided for accessing game-specific functionality. */
@@ -77,6 +85,59 @@ public:
   virtual void LoadPlugins(const std::vector<std::string>& plugins,
                            bool loadHeadersOnly) = 0;
 
+  /**
+   * @brief Parses plugins and loads their data, reporting the outcome for
+   *        each plugin instead of throwing if any are invalid.
+   * @details Behaves like ``LoadPlugins()``, except that plugins are not
+   *          checked for validity before loading begins. Instead, each plugin
+   *          is validated as it is parsed, so each file is only opened once,
+   *          and plugins that are invalid or cannot be read are left out of
+   *          the loaded plugins and reported in the returned results.
+   * @param plugins
+   *        The filenames of the plugins to load.
+   * @param loadHeadersOnly
+   *        If true, only the plugins' ``TES4`` headers are loaded. If false,
+   *        all records in the plugins are parsed, apart from the main master
+   *        file if it has been identified by a previous call to
+   *        ``IdentifyMainMasterFile()``.
+   * @returns A vector holding a PluginLoadResult for each of the given
+   *          plugins, in the order they were given.
+   */
+  virtual std::vector<PluginLoadResult> TryLoadPlugins(
+      const std::vector<std::string>& plugins,
+      bool loadHeadersOnly) = 0;
+
+  /**
+   * @brief Parses plugins and loads their data on a background thread.
+   * @details Behaves like ``LoadPlugins()``, but returns immediately. Only
+   *          one plugin loading or sorting operation runs at a time for a
+   *          given game handle, whether it is asynchronous or not: later
+   *          operations, and calls to ``SetThreadCount()`` and
+   *          ``GetSortStatistics()``, wait for earlier ones to finish, so
+   *          they must not be called from the progress callback. The game
+   *          handle must outlive the returned future.
+   *
+   *          If the operation is cancelled, plugins that had already been
+   *          loaded are kept and the future throws an
+   *          OperationCancelledError.
+   * @param plugins
+   *        The filenames of the plugins to load.
+   * @param loadHeadersOnly
+   *        If true, only the plugins' ``TES4`` headers are loaded.
+   * @param progressCallback
+   *        A function that is called as the operation progresses. It is called
+   *        from worker threads, but never concurrently. May be empty.
+   * @param cancellationToken
+   *        A token that can be used to cancel the operation. May be null.
+   * @returns A future that becomes ready once the plugins have been loaded,
+   *          and that rethrows any exception that loading threw.
+   */
+  virtual std::future<void> LoadPluginsAsync(
+      const std::vector<std::string>& plugins,
+      bool loadHeadersOnly,
+      ProgressCallback progressCallback,
+      std::shared_ptr<const CancellationToken> cancellationToken) = 0;
+
   /**
    * @brief Get data for a loaded plugin.
    * @param  pluginName
@@ -97,6 +158,16 @@ public:
   virtual std::set<std::shared_ptr<const PluginInterface>> GetLoadedPlugins()
       const = 0;
 
+  /**
+   * @brief Set the maximum number of threads to use when loading plugins and
+   *        when checking plugins for overlapping records during sorting.
+   * @param threadCount
+   *        The maximum number of threads to use. If zero, the number of
+   *        threads is chosen based on the hardware's concurrency, which is
+   *        the default behaviour.
+   */
+  virtual void SetThreadCount(size_t threadCount) = 0;
+
   /**
    *  @}
    *  @name Sorting
@@ -110,6 +181,70 @@ public:
    */
   virtual void IdentifyMainMasterFile(const std::string& masterFile) = 0;
 
+  /**
+   *  @brief Set the engine used to order plugins that have no sorting
+   *         constraints between them.
+   *  @details The default engine is ``SortingEngine::compatibility``.
+   *  @param engine
+   *         The sorting engine to use for subsequent calls to
+   *         ``SortPlugins()``.
+   */
+  virtual void SetSortingEngine(SortingEngine engine) = 0;
+
+  /**
+   *  @brief Set the path of a file used to cache the result of sorting.
+   *  @details If a path is set, ``SortPlugins()`` fingerprints its inputs
+   *           after loading the given plugins. The fingerprint covers the
+   *           plugins' filenames, CRCs, sizes and modification times, the
+   *           load order, and the evaluated metadata that sorting uses. If
+   *           the fingerprint matches the one stored in the cache file, the
+   *           stored load order is returned without sorting. Otherwise the
+   *           plugins are sorted and the result is stored in the cache file,
+   *           replacing its previous content. Caching is disabled by default.
+   *  @param cachePath
+   *         The path of the cache file to use. Its parent directory must
+   *         exist. If empty, sorting results are not cached.
+   */
+  virtual void SetSortCachePath(const std::filesystem::path& cachePath) = 0;
+
+  /**
+   *  @brief Set the directory used to cache data read from plugins between
+   *         sessions.
+   *  @details If a directory is set, ``LoadPlugins()``, ``TryLoadPlugins()``
+   *           and ``SortPlugins()`` store the CRCs and override record counts
+   *           of fully-loaded plugins in a file in the directory, and reuse
+   *           them instead of rereading plugins that have not changed. A
+   *           plugin is considered unchanged if its path, size, modification
+   *           time and (on Linux) inode number are all unchanged. Plugins
+   *           are still parsed, as their records are needed for sorting. If
+   *           the cache file is corrupt, it is ignored and rewritten.
+   *           Caching is disabled by default.
+   *  @param directory
+   *         The directory to store the cache file in. It is created if it
+   *         does not exist. If empty, plugin data is not cached.
+   */
+  virtual void SetPluginDataCacheDirectory(
+      const std::filesystem::path& directory) = 0;
+
+  /**
+   *  @brief Set whether loading plugins should only reload plugins that
+   *         have changed since they were last loaded.
+   *  @details By default, ``LoadPlugins()``, ``TryLoadPlugins()`` and
+   *           ``SortPlugins()`` discard all loaded plugins and then load the
+   *           given plugins. If incremental loading is enabled, a given
+   *           plugin that is already loaded is kept if it was loaded in the
+   *           same way (header-only or fully) and its size, modification
+   *           time and (on Linux) inode number are unchanged, and if the
+   *           set of archives in the data directory is unchanged. Loaded
+   *           plugins that are not given are still discarded. If no plugins
+   *           are reloaded or discarded, the state used to evaluate metadata
+   *           conditions is left unchanged, so cached condition results are
+   *           kept.
+   *  @param incremental
+   *         Whether to load plugins incrementally.
+   */
+  virtual void SetIncrementalPluginLoading(bool incremental) = 0;
+
   /**
    *  @brief Calculates a new load order for the game's installed plugins
    *         (including inactive plugins) and outputs the sorted order.
@@ -126,6 +261,38 @@ public:
   virtual std::vector<std::string> SortPlugins(
       const std::vector<std::string>& plugins) = 0;
 
+  /**
+   *  @brief Sorts plugins on a background thread.
+   *  @details Behaves like ``SortPlugins()``, but returns immediately. The
+   *           same ordering and lifetime rules as for ``LoadPluginsAsync()``
+   *           apply. Cancellation is checked between sorting stages and
+   *           periodically during the slower stages.
+   *  @param plugins
+   *         A vector of filenames of the plugins to sort, in their current
+   *         load order.
+   *  @param progressCallback
+   *         A function that is called as each sorting stage starts. May be
+   *         empty.
+   *  @param cancellationToken
+   *         A token that can be used to cancel the sort. May be null.
+   *  @returns A future that holds the sorted load order, or that throws an
+   *           OperationCancelledError if the sort was cancelled.
+   */
+  virtual std::future<std::vector<std::string>> SortPluginsAsync(
+      const std::vector<std::string>& plugins,
+      ProgressCallback progressCallback,
+      std::shared_ptr<const CancellationToken> cancellationToken) = 0;
+
+  /**
+   *  @brief Get timings and counters recorded by the last call to
+   *         ``SortPlugins()``.
+   *  @details The statistics are reset at the start of each call to
+   *           ``SortPlugins()``, and are recorded even if it throws.
+   *  @returns A SortStatistics object. If ``SortPlugins()`` has not been
+   *           called, all its durations and counters are zero.
+   */
+  virtual SortStatistics GetSortStatistics() const = 0;
+
   /**
    *  @}
    *  @name Load Order Interaction
@@ -0,0 +1,87 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_OPERATION_PROGRESS
+#define LOOT_OPERATION_PROGRESS
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "loot/enum/operation_phase.h"
+
+namespace loot {
+/**
+ * @brief A structure that describes how far an asynchronous operation has
+ *        progressed.
+ */
+struct OperationProgress {
+  inline explicit OperationProgress() :
+      phase(OperationPhase::load_plugins),
+      plugins_loaded(0),
+      plugins_to_load(0),
+      bytes_loaded(0),
+      bytes_to_load(0) {}
+
+  /**
+   * @brief The phase that the operation is in.
+   */
+  OperationPhase phase;
+
+  /**
+   * @brief The number of plugins that have been loaded or have failed to
+   *        load so far.
+   */
+  size_t plugins_loaded;
+
+  /**
+   * @brief The number of plugins that are being loaded.
+   */
+  size_t plugins_to_load;
+
+  /**
+   * @brief The total size in bytes of the plugins counted by
+   *        ``plugins_loaded``. Fully loading a plugin involves reading and
+   *        hashing all of it, so this tracks the bulk of the loading work.
+   */
+  uintmax_t bytes_loaded;
+
+  /**
+   * @brief The total size in bytes of the plugins that are being loaded.
+   */
+  uintmax_t bytes_to_load;
+};
+
+/**
+ * @brief A function that is called with the current progress of an
+ *        asynchronous operation.
+ * @details The function is called when the operation enters a new phase and
+ *          after each plugin is loaded. It may be called from any thread,
+ *          but calls are never concurrent. It should return quickly, as the
+ *          operation waits for it.
+ */
+typedef std::function<void(const OperationProgress&)> ProgressCallback;
+}
+
+#endif
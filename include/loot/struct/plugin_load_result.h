@@ -0,0 +1,55 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+#ifndef LOOT_PLUGIN_LOAD_RESULT
+#define LOOT_PLUGIN_LOAD_RESULT
+
+#include <string>
+
+namespace loot {
+/**
+ * @brief A structure that holds the outcome of trying to load a plugin.
+ */
+struct PluginLoadResult {
+  inline explicit PluginLoadResult() : is_loaded(false) {}
+
+  /**
+   * @brief The filename of the plugin, as it was given to be loaded.
+   */
+  std::string name;
+
+  /**
+   * @brief `true` if the plugin was loaded, `false` if it is not a valid
+   *        plugin or could not be read.
+   */
+  bool is_loaded;
+
+  /**
+   * @brief A description of why the plugin was not loaded. This is empty if
+   *        the plugin was loaded.
+   */
+  std::string error_message;
+};
+}
+
+#endif
@@ -0,0 +1,139 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+#ifndef LOOT_SORT_STATISTICS
+#define LOOT_SORT_STATISTICS
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+
+#include "loot/enum/edge_type.h"
+
+namespace loot {
+/**
+ * @brief A structure that holds timings and counters recorded while sorting
+ *        plugins.
+ * @details Durations are measured using a steady clock. If sorting throws
+ *          an exception, the durations of the stages that completed and the
+ *          counters recorded up to that point are still set.
+ */
+struct SortStatistics {
+  inline explicit SortStatistics() :
+      total_duration(0),
+      load_plugins_duration(0),
+      add_vertices_duration(0),
+      add_specific_edges_duration(0),
+      add_hardcoded_edges_duration(0),
+      add_group_edges_duration(0),
+      add_overlap_edges_duration(0),
+      add_tie_break_edges_duration(0),
+      check_for_cycles_duration(0),
+      topological_sort_duration(0),
+      cycle_checks(0),
+      cyclic_edges_skipped(0),
+      overlap_checks(0),
+      vertex_count(0),
+      edge_count(0),
+      used_cached_result(false) {}
+
+  /** @brief The time taken by the whole sort, including loading plugins. */
+  std::chrono::microseconds total_duration;
+
+  /** @brief The time taken to load the plugins being sorted. */
+  std::chrono::microseconds load_plugins_duration;
+
+  /** @brief The time taken to add plugin and group vertices to the graph. */
+  std::chrono::microseconds add_vertices_duration;
+
+  /**
+   * @brief The time taken to add master, requirement and load after edges.
+   */
+  std::chrono::microseconds add_specific_edges_duration;
+
+  /** @brief The time taken to add edges for hardcoded plugins. */
+  std::chrono::microseconds add_hardcoded_edges_duration;
+
+  /** @brief The time taken to add group edges. */
+  std::chrono::microseconds add_group_edges_duration;
+
+  /**
+   * @brief The time taken to check plugins for overlap and add overlap edges.
+   */
+  std::chrono::microseconds add_overlap_edges_duration;
+
+  /**
+   * @brief The time taken to add tie-break edges. This is zero when using the
+   *        ``SortingEngine::priority`` engine, which doesn't add them.
+   */
+  std::chrono::microseconds add_tie_break_edges_duration;
+
+  /** @brief The time taken to check the graph for cycles. */
+  std::chrono::microseconds check_for_cycles_duration;
+
+  /** @brief The time taken to topologically sort the graph. */
+  std::chrono::microseconds topological_sort_duration;
+
+  /**
+   * @brief The number of edges added to the graph, keyed by their type. Edge
+   *        types with no edges added have no entry.
+   */
+  std::map<EdgeType, size_t> edges_added;
+
+  /**
+   * @brief The number of times an edge was checked to see if adding it would
+   *        create a cycle.
+   */
+  size_t cycle_checks;
+
+  /**
+   * @brief The number of edges that were not added because they would have
+   *        created a cycle.
+   */
+  size_t cyclic_edges_skipped;
+
+  /**
+   * @brief The number of pairs of plugins that were compared to see if their
+   *        records overlap.
+   */
+  size_t overlap_checks;
+
+  /**
+   * @brief The number of vertices in the graph, including the vertices used
+   *        to represent groups. The graph only grows while sorting, so this
+   *        is also its peak size.
+   */
+  size_t vertex_count;
+
+  /** @brief The number of edges in the graph. */
+  size_t edge_count;
+
+  /**
+   * @brief `true` if the sorted load order was read from the sort cache, in
+   *        which case only the loading and total durations are set.
+   */
+  bool used_cached_result;
+};
+}
+
+#endif
@@ -50,7 +50,11 @@ void ApiDatabase::LoadLists(const std::filesystem::path& masterlistPath,
 
   if (!masterlistPath.empty()) {
     if (std::filesystem::exists(masterlistPath)) {
-      temp.Load(masterlistPath);
+      if (masterlistCachePath_.empty()) {
+        temp.Load(masterlistPath);
+      } else {
+        temp.Load(masterlistPath, masterlistCachePath_);
+      }
     } else {
       throw FileAccessError("The given masterlist path does not exist: " +
                             masterlistPath.u8string());
@@ -70,6 +74,11 @@ void ApiDatabase::LoadLists(const std::filesystem::path& masterlistPath,
   userlist_ = userTemp;
 }
 
+void ApiDatabase::SetMasterlistCachePath(
+    const std::filesystem::path& cachePath) {
+  masterlistCachePath_ = cachePath;
+}
+
 void ApiDatabase::WriteUserMetadata(const std::filesystem::path& outputFile,
                                     const bool overwrite) const {
   if (!std::filesystem::exists(outputFile.parent_path()))
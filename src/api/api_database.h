@@ -45,6 +45,8 @@ struct ApiDatabase : public DatabaseInterface {
   void LoadLists(const std::filesystem::path& masterlist_path,
                  const std::filesystem::path& userlist_path = "");
 
+  void SetMasterlistCachePath(const std::filesystem::path& cachePath);
+
   void WriteUserMetadata(const std::filesystem::path& outputFile,
                          const bool overwrite) const;
 
@@ -92,6 +94,7 @@ private:
   std::shared_ptr<ConditionEvaluator> conditionEvaluator_;
   Masterlist masterlist_;
   MetadataList userlist_;
+  std::filesystem::path masterlistCachePath_;
 };
 }
 
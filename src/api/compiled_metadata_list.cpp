@@ -0,0 +1,708 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "api/compiled_metadata_list.h"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "api/helpers/crc.h"
+#include "api/helpers/logging.h"
+#include "api/helpers/text.h"
+#include "api/metadata_list.h"
+#include "loot/loot_version.h"
+
+namespace loot {
+static constexpr const char FORMAT_LINE[] = "LOOT compiled metadata list v1\n";
+static constexpr size_t FORMAT_LINE_LENGTH = sizeof(FORMAT_LINE) - 1;
+
+// Each index bucket holds a 64-bit name hash and a 32-bit entry offset.
+static constexpr size_t INDEX_BUCKET_SIZE = 12;
+static constexpr uint32_t EMPTY_BUCKET = UINT32_MAX;
+
+// Integers are written in little-endian byte order, so that the format
+// doesn't depend on the platform.
+void AppendUint32(std::string& buffer, uint32_t value) {
+  for (int i = 0; i < 4; ++i) {
+    buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+  }
+}
+
+void AppendUint64(std::string& buffer, uint64_t value) {
+  for (int i = 0; i < 8; ++i) {
+    buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+  }
+}
+
+// 64-bit FNV-1a, which unlike std::hash gives the same result across
+// processes and platforms.
+uint64_t HashNormalizedName(const std::string& normalizedName) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (const auto& character : normalizedName) {
+    hash ^= (unsigned char)character;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+MetadataSourceKey GetMetadataSourceKey(const std::string& content) {
+  return MetadataSourceKey{content.size(),
+                           UpdateCrc32(0, content.data(), content.size())};
+}
+
+std::string GetFilenameKeyForm() {
+  // ASCII and non-ASCII names are normalised differently, so sample both.
+  // "\xC3\x89\xC3\x9F" is "Éß", which case folding and uppercasing treat
+  // differently.
+  return NormalizeFilename("A") + "/" + NormalizeFilename("\xC3\x89\xC3\x9F");
+}
+
+class CompiledListWriter {
+public:
+  size_t Offset() const { return data_.size(); }
+
+  void WriteUint8(uint8_t value) { data_.push_back(static_cast<char>(value)); }
+
+  void WriteUint32(uint32_t value) { AppendUint32(data_, value); }
+
+  void WriteUint64(uint64_t value) { AppendUint64(data_, value); }
+
+  // Strings are stored once in the string table, and referred to by their
+  // offset and length.
+  void WriteString(const std::string& value) {
+    auto it = stringOffsets_.find(value);
+    if (it == stringOffsets_.end()) {
+      it = stringOffsets_.emplace(value, (uint32_t)strings_.size()).first;
+      strings_ += value;
+    }
+
+    WriteUint32(it->second);
+    WriteUint32((uint32_t)value.size());
+  }
+
+  const std::string& GetData() const { return data_; }
+  const std::string& GetStrings() const { return strings_; }
+
+private:
+  std::string data_;
+  std::string strings_;
+  std::unordered_map<std::string, uint32_t> stringOffsets_;
+};
+
+class CompiledListReader {
+public:
+  CompiledListReader(const char* data,
+                     size_t size,
+                     const char* strings = nullptr,
+                     size_t stringsSize = 0) :
+      data_(data),
+      size_(size),
+      strings_(strings),
+      stringsSize_(stringsSize),
+      pos_(0) {}
+
+  void Seek(size_t pos) {
+    if (pos > size_) {
+      throw std::runtime_error("an offset is out of bounds");
+    }
+    pos_ = pos;
+  }
+
+  size_t Position() const { return pos_; }
+
+  const char* ReadBytes(size_t length) {
+    if (length > size_ - pos_) {
+      throw std::runtime_error("it is truncated");
+    }
+
+    auto bytes = data_ + pos_;
+    pos_ += length;
+    return bytes;
+  }
+
+  uint8_t ReadUint8() { return static_cast<uint8_t>(*ReadBytes(1)); }
+
+  uint32_t ReadUint32() {
+    auto bytes = reinterpret_cast<const unsigned char*>(ReadBytes(4));
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+      value |= static_cast<uint32_t>(bytes[i]) << (8 * i);
+    }
+    return value;
+  }
+
+  uint64_t ReadUint64() {
+    auto bytes = reinterpret_cast<const unsigned char*>(ReadBytes(8));
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+      value |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+    }
+    return value;
+  }
+
+  std::string ReadString() {
+    const size_t offset = ReadUint32();
+    const size_t length = ReadUint32();
+    if (offset > stringsSize_ || length > stringsSize_ - offset) {
+      throw std::runtime_error("a string is out of bounds");
+    }
+
+    return std::string(strings_ + offset, length);
+  }
+
+private:
+  const char* data_;
+  size_t size_;
+  const char* strings_;
+  size_t stringsSize_;
+  size_t pos_;
+};
+
+void WriteMessageContent(CompiledListWriter& writer,
+                         const std::vector<MessageContent>& content) {
+  writer.WriteUint32((uint32_t)content.size());
+  for (const auto& messageContent : content) {
+    writer.WriteString(messageContent.GetText());
+    writer.WriteString(messageContent.GetLanguage());
+  }
+}
+
+std::vector<MessageContent> ReadMessageContent(CompiledListReader& reader) {
+  std::vector<MessageContent> content(reader.ReadUint32());
+  for (auto& messageContent : content) {
+    auto text = reader.ReadString();
+    messageContent = MessageContent(text, reader.ReadString());
+  }
+  return content;
+}
+
+void WriteMessage(CompiledListWriter& writer, const Message& message) {
+  writer.WriteUint8((uint8_t)message.GetType());
+  WriteMessageContent(writer, message.GetContent());
+  writer.WriteString(message.GetCondition());
+}
+
+Message ReadMessage(CompiledListReader& reader) {
+  auto type = (MessageType)reader.ReadUint8();
+  auto content = ReadMessageContent(reader);
+  return Message(type, content, reader.ReadString());
+}
+
+void WriteFiles(CompiledListWriter& writer, const std::set<File>& files) {
+  writer.WriteUint32((uint32_t)files.size());
+  for (const auto& file : files) {
+    writer.WriteString(file.GetName());
+    writer.WriteString(file.GetDisplayName());
+    writer.WriteString(file.GetCondition());
+  }
+}
+
+std::set<File> ReadFiles(CompiledListReader& reader) {
+  std::set<File> files;
+  for (auto count = reader.ReadUint32(); count > 0; --count) {
+    auto name = reader.ReadString();
+    auto display = reader.ReadString();
+
+    // The display name defaults to the filename, so store it as empty again
+    // to recreate the original object.
+    if (display == name) {
+      display.clear();
+    }
+    files.insert(File(name, display, reader.ReadString()));
+  }
+  return files;
+}
+
+void WriteCleaningData(CompiledListWriter& writer,
+                       const std::set<PluginCleaningData>& cleaningData) {
+  writer.WriteUint32((uint32_t)cleaningData.size());
+  for (const auto& data : cleaningData) {
+    writer.WriteUint32(data.GetCRC());
+    writer.WriteString(data.GetCleaningUtility());
+    WriteMessageContent(writer, data.GetInfo());
+    writer.WriteUint32(data.GetITMCount());
+    writer.WriteUint32(data.GetDeletedReferenceCount());
+    writer.WriteUint32(data.GetDeletedNavmeshCount());
+  }
+}
+
+std::set<PluginCleaningData> ReadCleaningData(CompiledListReader& reader) {
+  std::set<PluginCleaningData> cleaningData;
+  for (auto count = reader.ReadUint32(); count > 0; --count) {
+    auto crc = reader.ReadUint32();
+    auto utility = reader.ReadString();
+    auto info = ReadMessageContent(reader);
+    auto itm = reader.ReadUint32();
+    auto ref = reader.ReadUint32();
+    auto nav = reader.ReadUint32();
+    cleaningData.insert(PluginCleaningData(crc, utility, info, itm, ref, nav));
+  }
+  return cleaningData;
+}
+
+void WritePluginMetadata(CompiledListWriter& writer,
+                         const PluginMetadata& metadata) {
+  writer.WriteString(metadata.GetName());
+  writer.WriteUint8(metadata.IsEnabled() ? 1 : 0);
+
+  auto group = metadata.GetGroup();
+  writer.WriteUint8(group.has_value() ? 1 : 0);
+  if (group.has_value()) {
+    writer.WriteString(group.value());
+  }
+
+  WriteFiles(writer, metadata.GetLoadAfterFiles());
+  WriteFiles(writer, metadata.GetRequirements());
+  WriteFiles(writer, metadata.GetIncompatibilities());
+
+  auto messages = metadata.GetMessages();
+  writer.WriteUint32((uint32_t)messages.size());
+  for (const auto& message : messages) {
+    WriteMessage(writer, message);
+  }
+
+  auto tags = metadata.GetTags();
+  writer.WriteUint32((uint32_t)tags.size());
+  for (const auto& tag : tags) {
+    writer.WriteString(tag.GetName());
+    writer.WriteUint8(tag.IsAddition() ? 1 : 0);
+    writer.WriteString(tag.GetCondition());
+  }
+
+  WriteCleaningData(writer, metadata.GetDirtyInfo());
+  WriteCleaningData(writer, metadata.GetCleanInfo());
+
+  auto locations = metadata.GetLocations();
+  writer.WriteUint32((uint32_t)locations.size());
+  for (const auto& location : locations) {
+    writer.WriteString(location.GetURL());
+    writer.WriteString(location.GetName());
+  }
+}
+
+PluginMetadata ReadPluginMetadata(CompiledListReader& reader) {
+  PluginMetadata metadata(reader.ReadString());
+  metadata.SetEnabled(reader.ReadUint8() != 0);
+
+  if (reader.ReadUint8() != 0) {
+    metadata.SetGroup(reader.ReadString());
+  }
+
+  metadata.SetLoadAfterFiles(ReadFiles(reader));
+  metadata.SetRequirements(ReadFiles(reader));
+  metadata.SetIncompatibilities(ReadFiles(reader));
+
+  std::vector<Message> messages(reader.ReadUint32());
+  for (auto& message : messages) {
+    message = ReadMessage(reader);
+  }
+  metadata.SetMessages(messages);
+
+  std::set<Tag> tags;
+  for (auto count = reader.ReadUint32(); count > 0; --count) {
+    auto name = reader.ReadString();
+    auto isAddition = reader.ReadUint8() != 0;
+    tags.insert(Tag(name, isAddition, reader.ReadString()));
+  }
+  metadata.SetTags(tags);
+
+  metadata.SetDirtyInfo(ReadCleaningData(reader));
+  metadata.SetCleanInfo(ReadCleaningData(reader));
+
+  std::set<Location> locations;
+  for (auto count = reader.ReadUint32(); count > 0; --count) {
+    auto url = reader.ReadString();
+    locations.insert(Location(url, reader.ReadString()));
+  }
+  metadata.SetLocations(locations);
+
+  return metadata;
+}
+
+CompiledMetadataList::CompiledMetadataList(std::unique_ptr<MappedFile> file,
+                                           size_t dataOffset,
+                                           size_t dataSize,
+                                           size_t stringsOffset,
+                                           size_t stringsSize) :
+    file_(std::move(file)),
+    dataOffset_(dataOffset),
+    dataSize_(dataSize),
+    stringsOffset_(stringsOffset),
+    stringsSize_(stringsSize),
+    globalsOffset_(0),
+    regexPluginsOffset_(0),
+    pluginsOffset_(0),
+    indexOffset_(0),
+    indexBucketCount_(0) {}
+
+std::shared_ptr<const CompiledMetadataList> CompiledMetadataList::Open(
+    const std::filesystem::path& path,
+    const MetadataSourceKey& sourceKey) {
+  std::error_code errorCode;
+  if (!std::filesystem::exists(path, errorCode)) {
+    return nullptr;
+  }
+
+  auto logger = getLogger();
+  try {
+    auto file = std::make_unique<MappedFile>(path);
+    CompiledListReader reader(file->Data(), file->Size());
+
+    if (file->Size() < FORMAT_LINE_LENGTH ||
+        std::string(reader.ReadBytes(FORMAT_LINE_LENGTH),
+                    FORMAT_LINE_LENGTH) != FORMAT_LINE) {
+      throw std::runtime_error("its format is not recognised");
+    }
+
+    // Filename normalisation may change between versions and differs between
+    // platforms, and either would invalidate the index.
+    auto versionLength = reader.ReadUint32();
+    std::string version(reader.ReadBytes(versionLength), versionLength);
+    auto keyFormLength = reader.ReadUint32();
+    std::string keyForm(reader.ReadBytes(keyFormLength), keyFormLength);
+    auto sourceSize = reader.ReadUint64();
+    auto sourceCrc = reader.ReadUint32();
+    if (version != LootVersion::GetVersionString() ||
+        keyForm != GetFilenameKeyForm() || sourceSize != sourceKey.size ||
+        sourceCrc != sourceKey.crc) {
+      if (logger) {
+        logger->debug(
+            "The compiled metadata list at \"{}\" is out of date.",
+            path.u8string());
+      }
+      return nullptr;
+    }
+
+    auto payloadSize = reader.ReadUint64();
+    auto payloadCrc = reader.ReadUint32();
+    auto payloadOffset = reader.Position();
+    if (payloadSize != file->Size() - payloadOffset) {
+      throw std::runtime_error("it is truncated");
+    }
+    if (UpdateCrc32(0, file->Data() + payloadOffset, payloadSize) !=
+        payloadCrc) {
+      throw std::runtime_error("its checksum does not match its content");
+    }
+
+    const size_t dataSize = reader.ReadUint32();
+    const size_t stringsSize = reader.ReadUint32();
+    const size_t globalsOffset = reader.ReadUint32();
+    const size_t regexPluginsOffset = reader.ReadUint32();
+    const size_t pluginsOffset = reader.ReadUint32();
+    const size_t indexOffset = reader.ReadUint32();
+
+    const auto dataOffset = reader.Position();
+    reader.ReadBytes(dataSize);
+    const auto stringsOffset = reader.Position();
+    reader.ReadBytes(stringsSize);
+
+    std::shared_ptr<CompiledMetadataList> list(new CompiledMetadataList(
+        std::move(file), dataOffset, dataSize, stringsOffset, stringsSize));
+    list->globalsOffset_ = globalsOffset;
+    list->regexPluginsOffset_ = regexPluginsOffset;
+    list->pluginsOffset_ = pluginsOffset;
+    list->indexOffset_ = indexOffset;
+
+    auto indexReader = list->GetReader(indexOffset);
+    list->indexBucketCount_ = indexReader.ReadUint32();
+    if (list->indexBucketCount_ == 0 ||
+        (list->indexBucketCount_ & (list->indexBucketCount_ - 1)) != 0) {
+      throw std::runtime_error("its index is invalid");
+    }
+    indexReader.ReadBytes(list->indexBucketCount_ * INDEX_BUCKET_SIZE);
+
+    return list;
+  } catch (const std::exception& e) {
+    if (logger) {
+      logger->warn(
+          "Ignoring the compiled metadata list at \"{}\" because {}.",
+          path.u8string(),
+          e.what());
+    }
+    return nullptr;
+  }
+}
+
+void CompiledMetadataList::Write(const std::filesystem::path& path,
+                                 const MetadataSourceKey& sourceKey,
+                                 const MetadataList& metadataList) {
+  CompiledListWriter writer;
+
+  const auto globalsOffset = writer.Offset();
+  auto bashTags = metadataList.BashTags();
+  writer.WriteUint32((uint32_t)bashTags.size());
+  for (const auto& tag : bashTags) {
+    writer.WriteString(tag);
+  }
+
+  auto groups = metadataList.Groups();
+  writer.WriteUint32((uint32_t)groups.size());
+  for (const auto& group : groups) {
+    writer.WriteString(group.GetName());
+    writer.WriteString(group.GetDescription());
+
+    auto afterGroups = group.GetAfterGroups();
+    writer.WriteUint32((uint32_t)afterGroups.size());
+    for (const auto& afterGroup : afterGroups) {
+      writer.WriteString(afterGroup);
+    }
+  }
+
+  auto messages = metadataList.Messages();
+  writer.WriteUint32((uint32_t)messages.size());
+  for (const auto& message : messages) {
+    WriteMessage(writer, message);
+  }
+
+  std::vector<PluginMetadata> regexPlugins;
+  std::vector<std::pair<std::string, PluginMetadata>> plugins;
+  for (const auto& plugin : metadataList.Plugins()) {
+    if (plugin.IsRegexPlugin()) {
+      regexPlugins.push_back(plugin);
+    } else {
+      plugins.emplace_back(NormalizeFilename(plugin.GetName()), plugin);
+    }
+  }
+
+  // Regex entries are stored in the order that they were loaded, as that's
+  // the order in which they're merged.
+  const auto regexPluginsOffset = writer.Offset();
+  writer.WriteUint32((uint32_t)regexPlugins.size());
+  for (const auto& plugin : regexPlugins) {
+    WritePluginMetadata(writer, plugin);
+  }
+
+  // Other entries are stored in a consistent order so that compiling the
+  // same content always gives the same file.
+  std::sort(plugins.begin(),
+            plugins.end(),
+            [](const auto& lhs, const auto& rhs) {
+              return lhs.first < rhs.first;
+            });
+
+  std::vector<uint32_t> entryOffsets;
+  for (const auto& plugin : plugins) {
+    entryOffsets.push_back((uint32_t)writer.Offset());
+    writer.WriteString(plugin.first);
+    WritePluginMetadata(writer, plugin.second);
+  }
+
+  const auto pluginsOffset = writer.Offset();
+  writer.WriteUint32((uint32_t)entryOffsets.size());
+  for (const auto& entryOffset : entryOffsets) {
+    writer.WriteUint32(entryOffset);
+  }
+
+  // The index is an open-addressing hash table with linear probing that is
+  // kept at most half full, so lookups stop at an empty bucket quickly.
+  uint32_t bucketCount = 1;
+  while (bucketCount < 2 * plugins.size()) {
+    bucketCount *= 2;
+  }
+
+  std::vector<std::pair<uint64_t, uint32_t>> buckets(
+      bucketCount, std::make_pair(0, EMPTY_BUCKET));
+  for (size_t i = 0; i < plugins.size(); ++i) {
+    auto hash = HashNormalizedName(plugins[i].first);
+    auto bucket = hash & (bucketCount - 1);
+    while (buckets[bucket].second != EMPTY_BUCKET) {
+      bucket = (bucket + 1) & (bucketCount - 1);
+    }
+    buckets[bucket] = std::make_pair(hash, entryOffsets[i]);
+  }
+
+  const auto indexOffset = writer.Offset();
+  writer.WriteUint32(bucketCount);
+  for (const auto& bucket : buckets) {
+    writer.WriteUint64(bucket.first);
+    writer.WriteUint32(bucket.second);
+  }
+
+  std::string payload;
+  AppendUint32(payload, (uint32_t)writer.GetData().size());
+  AppendUint32(payload, (uint32_t)writer.GetStrings().size());
+  AppendUint32(payload, (uint32_t)globalsOffset);
+  AppendUint32(payload, (uint32_t)regexPluginsOffset);
+  AppendUint32(payload, (uint32_t)pluginsOffset);
+  AppendUint32(payload, (uint32_t)indexOffset);
+  payload += writer.GetData();
+  payload += writer.GetStrings();
+
+  auto version = LootVersion::GetVersionString();
+  auto keyForm = GetFilenameKeyForm();
+  std::string header(FORMAT_LINE, FORMAT_LINE_LENGTH);
+  AppendUint32(header, (uint32_t)version.size());
+  header += version;
+  AppendUint32(header, (uint32_t)keyForm.size());
+  header += keyForm;
+  AppendUint64(header, sourceKey.size);
+  AppendUint32(header, sourceKey.crc);
+  AppendUint64(header, payload.size());
+  AppendUint32(header, UpdateCrc32(0, payload.data(), payload.size()));
+
+  // Write to a temporary file first so that an interrupted write can't
+  // replace a valid file with a partial one.
+  auto tempPath = path;
+  tempPath += ".tmp";
+
+  std::ofstream out(tempPath, std::ios::binary);
+  out << header << payload;
+  out.close();
+
+  std::error_code errorCode;
+  if (out.good()) {
+    std::filesystem::rename(tempPath, path, errorCode);
+  }
+
+  if (!out.good() || errorCode) {
+    auto logger = getLogger();
+    if (logger) {
+      logger->warn("Failed to write the compiled metadata list at \"{}\"",
+                   path.u8string());
+    }
+    std::filesystem::remove(tempPath, errorCode);
+  }
+}
+
+CompiledListReader CompiledMetadataList::GetReader(size_t offset) const {
+  CompiledListReader reader(file_->Data() + dataOffset_,
+                            dataSize_,
+                            file_->Data() + stringsOffset_,
+                            stringsSize_);
+  reader.Seek(offset);
+  return reader;
+}
+
+std::set<std::string> CompiledMetadataList::GetBashTags() const {
+  auto reader = GetReader(globalsOffset_);
+
+  std::set<std::string> bashTags;
+  for (auto count = reader.ReadUint32(); count > 0; --count) {
+    bashTags.insert(reader.ReadString());
+  }
+
+  return bashTags;
+}
+
+std::unordered_set<Group> CompiledMetadataList::GetGroups() const {
+  auto reader = GetReader(globalsOffset_);
+  for (auto count = reader.ReadUint32(); count > 0; --count) {
+    reader.ReadString();
+  }
+
+  std::unordered_set<Group> groups;
+  for (auto count = reader.ReadUint32(); count > 0; --count) {
+    auto name = reader.ReadString();
+    auto description = reader.ReadString();
+
+    std::unordered_set<std::string> afterGroups;
+    for (auto afterCount = reader.ReadUint32(); afterCount > 0;
+         --afterCount) {
+      afterGroups.insert(reader.ReadString());
+    }
+
+    groups.insert(Group(name, afterGroups, description));
+  }
+
+  return groups;
+}
+
+std::vector<Message> CompiledMetadataList::GetMessages() const {
+  // Skip the Bash Tags and groups, which precede the messages.
+  auto reader = GetReader(globalsOffset_);
+  for (auto count = reader.ReadUint32(); count > 0; --count) {
+    reader.ReadString();
+  }
+  for (auto count = reader.ReadUint32(); count > 0; --count) {
+    reader.ReadString();
+    reader.ReadString();
+    for (auto afterCount = reader.ReadUint32(); afterCount > 0;
+         --afterCount) {
+      reader.ReadString();
+    }
+  }
+
+  std::vector<Message> messages(reader.ReadUint32());
+  for (auto& message : messages) {
+    message = ReadMessage(reader);
+  }
+
+  return messages;
+}
+
+std::vector<PluginMetadata> CompiledMetadataList::GetRegexPlugins() const {
+  auto reader = GetReader(regexPluginsOffset_);
+
+  std::vector<PluginMetadata> plugins(reader.ReadUint32());
+  for (auto& plugin : plugins) {
+    plugin = ReadPluginMetadata(reader);
+  }
+
+  return plugins;
+}
+
+std::vector<PluginMetadata> CompiledMetadataList::GetPlugins() const {
+  auto reader = GetReader(pluginsOffset_);
+
+  std::vector<PluginMetadata> plugins(reader.ReadUint32());
+  for (auto& plugin : plugins) {
+    auto entryReader = GetReader(reader.ReadUint32());
+    entryReader.ReadString();
+    plugin = ReadPluginMetadata(entryReader);
+  }
+
+  return plugins;
+}
+
+std::optional<PluginMetadata> CompiledMetadataList::FindPlugin(
+    const std::string& pluginName) const {
+  const auto normalizedName = NormalizeFilename(TrimGhostExtension(pluginName));
+  const auto hash = HashNormalizedName(normalizedName);
+  const auto mask = indexBucketCount_ - 1;
+
+  auto bucket = hash & mask;
+  for (uint32_t probes = 0; probes < indexBucketCount_; ++probes) {
+    auto reader = GetReader(indexOffset_ + 4 + bucket * INDEX_BUCKET_SIZE);
+    auto bucketHash = reader.ReadUint64();
+    auto entryOffset = reader.ReadUint32();
+
+    if (entryOffset == EMPTY_BUCKET) {
+      break;
+    }
+
+    if (bucketHash == hash) {
+      auto entryReader = GetReader(entryOffset);
+      if (entryReader.ReadString() == normalizedName) {
+        return ReadPluginMetadata(entryReader);
+      }
+    }
+
+    bucket = (bucket + 1) & mask;
+  }
+
+  return std::nullopt;
+}
+}
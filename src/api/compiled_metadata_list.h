@@ -0,0 +1,115 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_API_COMPILED_METADATA_LIST
+#define LOOT_API_COMPILED_METADATA_LIST
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "api/helpers/mapped_file.h"
+#include "loot/metadata/group.h"
+#include "loot/metadata/message.h"
+#include "loot/metadata/plugin_metadata.h"
+
+namespace loot {
+class CompiledListReader;
+class MetadataList;
+
+// Identifies the content of the metadata file that a compiled list was
+// compiled from.
+struct MetadataSourceKey {
+  uint64_t size;
+  uint32_t crc;
+};
+
+MetadataSourceKey GetMetadataSourceKey(const std::string& content);
+
+// Identifies how plugin names are normalised before they're hashed into a
+// compiled list's index, which differs between platforms.
+std::string GetFilenameKeyForm();
+
+// A metadata list stored in a flat binary file, so that it can be loaded
+// without parsing YAML. The file contains a table of deduplicated strings,
+// the list's globals, its regex plugin entries, and its other plugin entries
+// with an index of their normalised filename hashes. The file is
+// memory-mapped, and plugin entries are only decoded when they're found or
+// listed.
+class CompiledMetadataList {
+public:
+  // Returns nullptr if the file doesn't exist, is corrupt, was written by a
+  // different version of libloot or with a different filename key form, or
+  // was compiled from different content.
+  static std::shared_ptr<const CompiledMetadataList> Open(
+      const std::filesystem::path& path,
+      const MetadataSourceKey& sourceKey);
+
+  // Writes the given metadata list to the given path, replacing any existing
+  // file. Failure to write is logged but otherwise ignored.
+  static void Write(const std::filesystem::path& path,
+                    const MetadataSourceKey& sourceKey,
+                    const MetadataList& metadataList);
+
+  std::set<std::string> GetBashTags() const;
+  std::unordered_set<Group> GetGroups() const;
+  std::vector<Message> GetMessages() const;
+
+  std::vector<PluginMetadata> GetRegexPlugins() const;
+
+  // Gets all plugin entries that aren't regex entries.
+  std::vector<PluginMetadata> GetPlugins() const;
+
+  // Finds the entry for the given plugin, ignoring regex entries.
+  std::optional<PluginMetadata> FindPlugin(const std::string& pluginName) const;
+
+private:
+  CompiledMetadataList(std::unique_ptr<MappedFile> file,
+                       size_t dataOffset,
+                       size_t dataSize,
+                       size_t stringsOffset,
+                       size_t stringsSize);
+
+  CompiledListReader GetReader(size_t offset) const;
+
+  std::unique_ptr<MappedFile> file_;
+  size_t dataOffset_;
+  size_t dataSize_;
+  size_t stringsOffset_;
+  size_t stringsSize_;
+
+  size_t globalsOffset_;
+  size_t regexPluginsOffset_;
+  size_t pluginsOffset_;
+  size_t indexOffset_;
+  uint32_t indexBucketCount_;
+};
+}
+
+#endif
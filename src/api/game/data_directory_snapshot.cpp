@@ -0,0 +1,143 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "api/game/data_directory_snapshot.h"
+
+#include <cstdint>
+
+#include "api/helpers/logging.h"
+#include "api/helpers/text.h"
+#include "api/plugin.h"
+
+namespace loot {
+// Marks a normalised filename that more than one file has.
+static constexpr size_t AMBIGUOUS_INDEX = SIZE_MAX;
+
+static constexpr const char* GHOST_EXTENSION = ".ghost";
+
+DataFile FindPluginFile(std::filesystem::path pluginPath) {
+  DataFile file;
+  file.name = pluginPath.filename().u8string();
+
+  std::error_code errorCode;
+  if (!std::filesystem::exists(pluginPath, errorCode)) {
+    pluginPath += GHOST_EXTENSION;
+  }
+
+  file.key = PluginDataCache::GetFileKey(pluginPath);
+  file.path = pluginPath;
+
+  return file;
+}
+
+DataDirectorySnapshot::DataDirectorySnapshot(
+    const std::filesystem::path& dataPath,
+    GameType gameType) {
+  for (std::filesystem::directory_iterator it(dataPath);
+       it != std::filesystem::directory_iterator();
+       ++it) {
+    DataFile file;
+    file.name = it->path().filename().u8string();
+    file.path = it->path();
+
+    if (hasPluginFileExtension(file.name, gameType)) {
+      file.key = PluginDataCache::GetFileKey(file.path);
+    }
+
+    const auto index = files_.size();
+    filesByName_.emplace(file.name, index);
+
+    auto normalizedName = NormalizeFilename(file.name);
+    auto inserted = filesByNormalizedName_.emplace(normalizedName, index);
+    if (!inserted.second) {
+      inserted.first->second = AMBIGUOUS_INDEX;
+    }
+
+    files_.push_back(std::move(file));
+  }
+
+  auto logger = getLogger();
+  if (logger) {
+    logger->trace("Took a snapshot of {} files in the data directory.",
+                  files_.size());
+  }
+}
+
+std::optional<DataFile> DataDirectorySnapshot::FindFile(
+    const std::string& filename) const {
+  auto file = Find(filename);
+  if (file == nullptr) {
+    return std::nullopt;
+  }
+
+  DataFile result = *file;
+  result.name = filename;
+  return result;
+}
+
+std::optional<DataFile> DataDirectorySnapshot::FindPlugin(
+    const std::string& pluginName) const {
+  auto file = Find(pluginName);
+  if (file == nullptr) {
+    file = Find(pluginName + GHOST_EXTENSION);
+  }
+
+  if (file == nullptr) {
+    return std::nullopt;
+  }
+
+  DataFile result = *file;
+  result.name = pluginName;
+  return result;
+}
+
+std::vector<std::filesystem::path> DataDirectorySnapshot::GetPathsWithExtension(
+    const std::string& extension) const {
+  const auto normalizedExtension = NormalizeFilename(extension);
+
+  std::vector<std::filesystem::path> paths;
+  for (const auto& file : files_) {
+    auto fileExtension = file.path.extension().u8string();
+    if (NormalizeFilename(fileExtension) == normalizedExtension) {
+      paths.push_back(file.path);
+    }
+  }
+
+  return paths;
+}
+
+const DataFile* DataDirectorySnapshot::Find(const std::string& filename) const {
+  auto it = filesByName_.find(filename);
+  if (it != filesByName_.end()) {
+    return &files_[it->second];
+  }
+
+  it = filesByNormalizedName_.find(NormalizeFilename(filename));
+  if (it != filesByNormalizedName_.end() && it->second != AMBIGUOUS_INDEX) {
+    return &files_[it->second];
+  }
+
+  return nullptr;
+}
+}
@@ -0,0 +1,87 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_API_GAME_DATA_DIRECTORY_SNAPSHOT
+#define LOOT_API_GAME_DATA_DIRECTORY_SNAPSHOT
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "api/game/plugin_data_cache.h"
+#include "loot/enum/game_type.h"
+
+namespace loot {
+// A file in the game's Data directory.
+struct DataFile {
+  // The filename that was looked up, without any .ghost extension that was
+  // added to find the file.
+  std::string name;
+
+  // The path to the file, including any .ghost extension.
+  std::filesystem::path path;
+
+  // The file's size, modification time and ID, or nullopt if they couldn't
+  // be read or weren't read because the file isn't a plugin.
+  std::optional<PluginFileKey> key;
+};
+
+// Finds a plugin file by checking the filesystem directly, adding a .ghost
+// extension to its path if the path doesn't exist.
+DataFile FindPluginFile(std::filesystem::path pluginPath);
+
+// A listing of the files in the game's Data directory, read in one pass so
+// that checking for files and their metadata doesn't need to access the
+// filesystem. The metadata is only read for files with plugin extensions.
+class DataDirectorySnapshot {
+public:
+  explicit DataDirectorySnapshot(const std::filesystem::path& dataPath,
+                                 GameType gameType);
+
+  // Filenames are matched exactly if possible, and otherwise
+  // case-insensitively, so that files are found like they would be on a
+  // case-insensitive filesystem. A case-insensitive match is only used if it
+  // is unique.
+  std::optional<DataFile> FindFile(const std::string& filename) const;
+
+  // Like FindFile(), but if no file is found, looks for the filename with a
+  // .ghost extension added.
+  std::optional<DataFile> FindPlugin(const std::string& pluginName) const;
+
+  // The extension is compared case-insensitively.
+  std::vector<std::filesystem::path> GetPathsWithExtension(
+      const std::string& extension) const;
+
+private:
+  const DataFile* Find(const std::string& filename) const;
+
+  std::vector<DataFile> files_;
+  std::unordered_map<std::string, size_t> filesByName_;
+  std::unordered_map<std::string, size_t> filesByNormalizedName_;
+};
+}
+
+#endif
@@ -25,15 +25,22 @@
 #include "api/game/game.h"
 
 #include <algorithm>
-#include <cmath>
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <map>
+#include <mutex>
 #include <thread>
+#include <unordered_map>
 
 #include <boost/algorithm/string.hpp>
 
 #include "api/api_database.h"
+#include "api/game/plugin_data_cache.h"
 #include "api/helpers/logging.h"
+#include "api/helpers/text.h"
 #include "api/sorting/plugin_sort.h"
+#include "api/sorting/plugin_sort_cache.h"
 #include "loot/exception/file_access_error.h"
 
 #ifdef _WIN32
@@ -55,13 +62,44 @@ using std::vector;
 using std::filesystem::u8path;
 
 namespace loot {
+// Finds the file for the given plugin in the snapshot, falling back to the
+// filesystem for names that the snapshot can't resolve, such as names with a
+// directory component or that match more than one file case-insensitively.
+DataFile ResolvePluginFile(const DataDirectorySnapshot& snapshot,
+                           const std::filesystem::path& dataPath,
+                           const std::string& pluginName) {
+  auto file = snapshot.FindPlugin(pluginName);
+  if (file.has_value()) {
+    return file.value();
+  }
+
+  auto fallbackFile = FindPluginFile(dataPath / u8path(pluginName));
+  fallbackFile.name = pluginName;
+  return fallbackFile;
+}
+
+// Check if the given loaded plugin would be loaded the same way again.
+bool IsPluginUnchanged(const Plugin& plugin,
+                       const DataFile& file,
+                       bool headerOnly) {
+  if (plugin.GetName() != file.name || plugin.IsHeaderOnly() != headerOnly ||
+      !plugin.GetFileKey().has_value() || !file.key.has_value()) {
+    return false;
+  }
+
+  return file.key.value() == plugin.GetFileKey().value();
+}
+
 Game::Game(const GameType gameType,
            const std::filesystem::path& gamePath,
            const std::filesystem::path& localDataPath) :
     type_(gameType),
     gamePath_(gamePath),
     cache_(std::make_shared<GameCache>()),
-    loadOrderHandler_(std::make_shared<LoadOrderHandler>()) {
+    loadOrderHandler_(std::make_shared<LoadOrderHandler>()),
+    sortingEngine_(SortingEngine::compatibility),
+    threadCount_(0),
+    incrementalPluginLoading_(false) {
   auto logger = getLogger();
   if (logger) {
     logger->info("Initialising load order data for game of type {} at: {}",
@@ -93,6 +131,46 @@ std::shared_ptr<LoadOrderHandler> Game::GetLoadOrderHandler() {
   return loadOrderHandler_;
 }
 
+SortingEngine Game::GetSortingEngine() const { return sortingEngine_; }
+
+size_t Game::GetThreadCount() const {
+  const size_t threadCount = threadCount_;
+  if (threadCount != 0) {
+    return threadCount;
+  }
+
+  // hardware_concurrency() may be zero, if so then use only one thread.
+  return ::std::max((size_t)thread::hardware_concurrency(), (size_t)1);
+}
+
+std::shared_ptr<ThreadPool> Game::GetThreadPool() {
+  // The pool's threads persist between calls, and are only replaced if the
+  // thread count has changed since the pool was created.
+  std::lock_guard<std::mutex> lock(threadPoolMutex_);
+  const auto threadCount = GetThreadCount();
+  if (!threadPool_ || threadPool_->ThreadCount() != threadCount) {
+    threadPool_ = std::make_shared<ThreadPool>(threadCount);
+  }
+
+  return threadPool_;
+}
+
+std::shared_ptr<const DataDirectorySnapshot> Game::GetDataDirectorySnapshot() {
+  if (!dataDirectorySnapshot_) {
+    return TakeDataDirectorySnapshot();
+  }
+
+  return dataDirectorySnapshot_;
+}
+
+std::shared_ptr<const DataDirectorySnapshot>
+Game::TakeDataDirectorySnapshot() {
+  dataDirectorySnapshot_ =
+      std::make_shared<DataDirectorySnapshot>(DataPath(), Type());
+
+  return dataDirectorySnapshot_;
+}
+
 std::shared_ptr<DatabaseInterface> Game::GetDatabase() { return database_; }
 
 bool Game::IsValidPlugin(const std::string& plugin) const {
@@ -101,98 +179,260 @@ bool Game::IsValidPlugin(const std::string& plugin) const {
 
 void Game::LoadPlugins(const std::vector<std::string>& plugins,
                        bool loadHeadersOnly) {
-  auto logger = getLogger();
-  uintmax_t meanFileSize = 0;
-  std::multimap<uintmax_t, string> sizeMap;
+  std::lock_guard<std::mutex> guard(operationMutex_);
 
-  // First get the plugin sizes.
-  for (const auto& plugin : plugins) {
-    if (!IsValidPlugin(plugin))
-      throw std::invalid_argument("\"" + plugin + "\" is not a valid plugin");
+  OperationMonitor monitor;
+  LoadPlugins(plugins, loadHeadersOnly, monitor);
+}
 
-    uintmax_t fileSize = Plugin::GetFileSize(DataPath() / u8path(plugin));
-    meanFileSize += fileSize;
+std::future<void> Game::LoadPluginsAsync(
+    const std::vector<std::string>& plugins,
+    bool loadHeadersOnly,
+    ProgressCallback progressCallback,
+    std::shared_ptr<const CancellationToken> cancellationToken) {
+  return std::async(
+      std::launch::async,
+      [this, plugins, loadHeadersOnly, progressCallback, cancellationToken]() {
+        std::lock_guard<std::mutex> guard(operationMutex_);
+
+        OperationMonitor monitor(progressCallback, cancellationToken);
+        monitor.ThrowIfCancelled();
+        LoadPlugins(plugins, loadHeadersOnly, monitor);
+      });
+}
 
-    // Trim .ghost extension if present.
-    if (boost::iends_with(plugin, ".ghost"))
-      sizeMap.emplace(fileSize, plugin.substr(0, plugin.length() - 6));
-    else
-      sizeMap.emplace(fileSize, plugin);
-  }
-  meanFileSize /= sizeMap.size();  // Rounding error, but not important.
+std::vector<PluginLoadResult> Game::TryLoadPlugins(
+    const std::vector<std::string>& plugins,
+    bool loadHeadersOnly) {
+  std::lock_guard<std::mutex> guard(operationMutex_);
 
-  // Get the number of threads to use.
-  // hardware_concurrency() may be zero, if so then use only one thread.
-  size_t threadsToUse =
-      ::std::min((size_t)thread::hardware_concurrency(), sizeMap.size());
-  threadsToUse = ::std::max(threadsToUse, (size_t)1);
+  OperationMonitor monitor;
+  auto snapshot = TakeDataDirectorySnapshot();
+  return LoadPluginFiles(plugins, loadHeadersOnly, *snapshot, monitor);
+}
 
-  // Divide the plugins up by thread.
-  unsigned int pluginsPerThread = ceil((double)sizeMap.size() / threadsToUse);
-  vector<vector<string>> pluginGroups(threadsToUse);
-  if (logger) {
-    logger->info(
-        "Loading {} plugins using {} threads, with up to {} plugins per "
-        "thread.",
-        sizeMap.size(),
-        threadsToUse,
-        pluginsPerThread);
+void Game::LoadPlugins(const std::vector<std::string>& plugins,
+                       bool loadHeadersOnly,
+                       OperationMonitor& monitor) {
+  auto snapshot = TakeDataDirectorySnapshot();
+  for (const auto& plugin : plugins) {
+    // Validate the file that will be loaded, resolving it in the same way as
+    // LoadPluginFiles() does.
+    auto file =
+        ResolvePluginFile(*snapshot, DataPath(), TrimGhostExtension(plugin));
+
+    if (!Plugin::IsValid(Type(), file.path))
+      throw std::invalid_argument("\"" + plugin + "\" is not a valid plugin");
   }
 
-  // The plugins should be split between the threads so that the data
-  // load is as evenly spread as possible.
-  size_t currentGroup = 0;
-  for (const auto& plugin : sizeMap) {
-    if (currentGroup == threadsToUse) {
-      currentGroup = 0;
+  // Plugins that fail to load are logged and skipped: their errors are only
+  // reported by TryLoadPlugins().
+  LoadPluginFiles(plugins, loadHeadersOnly, *snapshot, monitor);
+}
+
+std::vector<PluginLoadResult> Game::LoadPluginFiles(
+    const std::vector<std::string>& plugins,
+    bool loadHeadersOnly,
+    const DataDirectorySnapshot& snapshot,
+    OperationMonitor& monitor) {
+  auto logger = getLogger();
+  std::vector<PluginLoadResult> results(plugins.size());
+  std::vector<DataFile> files(plugins.size());
+  std::multimap<uintmax_t, size_t> sizeMap;
+
+  // First get the plugin sizes from the snapshot. Each plugin is validated
+  // when it is parsed, so that files are only opened once.
+  for (size_t i = 0; i < plugins.size(); ++i) {
+    results[i].name = plugins[i];
+
+    if (!hasPluginFileExtension(plugins[i], Type())) {
+      results[i].error_message = "The file does not have a plugin extension.";
+      continue;
+    }
+
+    auto file =
+        ResolvePluginFile(snapshot, DataPath(), TrimGhostExtension(plugins[i]));
+    if (!file.key.has_value()) {
+      results[i].error_message = "The file does not exist or cannot be read.";
+      continue;
     }
 
-    pluginGroups[currentGroup].push_back(plugin.second);
-    ++currentGroup;
+    sizeMap.emplace(file.key.value().size, i);
+    files[i] = std::move(file);
   }
 
-  // Clear the existing plugin and archive caches.
-  cache_->ClearCachedPlugins();
+  // Search for and cache archives, checking if they have changed, as that
+  // may change which plugins load archives.
+  auto previousArchivePaths = cache_->GetArchivePaths();
   cache_->ClearCachedArchivePaths();
+  CacheArchives(snapshot);
+
+  // If loading incrementally, keep plugins that may be unchanged, and get
+  // them now before they can be replaced.
+  std::unordered_map<FilenameKey, std::shared_ptr<const Plugin>>
+      previousPlugins;
+  if (incrementalPluginLoading_ &&
+      previousArchivePaths == cache_->GetArchivePaths()) {
+    for (const auto& pluginIndex : sizeMap) {
+      auto pluginName = TrimGhostExtension(results[pluginIndex.second].name);
+      auto plugin = cache_->GetPlugin(pluginName);
+      if (plugin) {
+        previousPlugins.emplace(plugin->GetFilenameKey(), plugin);
+      }
+    }
+  }
 
-  // Search for and cache archives.
-  CacheArchives();
+  // All other plugins will be left out of the cache.
+  std::atomic<bool> pluginsChanged(!incrementalPluginLoading_);
+  auto loadedPlugins = cache_->GetPluginsSnapshot();
+  for (const auto& plugin : loadedPlugins->plugins) {
+    if (previousPlugins.count(plugin->GetFilenameKey()) == 0) {
+      pluginsChanged = true;
+      break;
+    }
+  }
 
-  // Load the plugins.
+  // Collect the plugins to cache privately, and publish them together once
+  // loading has finished, so that the cache is never seen partially loaded.
+  PluginsByName loadedPluginsByName;
+  std::mutex loadedPluginsMutex;
+  auto keepPlugin = [&](const std::shared_ptr<const Plugin>& plugin) {
+    std::lock_guard<std::mutex> lock(loadedPluginsMutex);
+    loadedPluginsByName.insert_or_assign(plugin->GetFilenameKey(), plugin);
+  };
+
+  // Load the plugins, largest first, so that the largest plugins are
+  // started as early as possible and the smaller plugins fill in around them.
+  auto threadPool = GetThreadPool();
   if (logger) {
+    logger->info("Loading {} plugins using {} threads.",
+                 sizeMap.size(),
+                 threadPool->ThreadCount());
     logger->trace("Starting plugin loading.");
   }
-  auto masterPath = DataPath() / u8path(masterFilename_);
-  vector<thread> threads;
-  while (threads.size() < threadsToUse) {
-    vector<string>& pluginGroup = pluginGroups[threads.size()];
-    threads.push_back(thread([&]() {
-      for (auto pluginName : pluginGroup) {
-        try {
-          auto pluginPath = DataPath() / u8path(pluginName);
-          const bool loadHeader =
-              loadHeadersOnly || loot::equivalent(pluginPath, masterPath);
-
-          cache_->AddPlugin(Plugin(Type(), cache_, pluginPath, loadHeader));
-        } catch (std::exception& e) {
-          if (logger) {
-            logger->error(
-                "Caught exception while trying to add {} to the cache: {}",
-                pluginName,
-                e.what());
-          }
+
+  std::unique_ptr<PluginDataCache> pluginDataCache;
+  if (!pluginDataCacheDirectory_.empty()) {
+    pluginDataCache =
+        std::make_unique<PluginDataCache>(pluginDataCacheDirectory_);
+  }
+
+  uintmax_t totalSize = 0;
+  for (const auto& pluginIndex : sizeMap) {
+    totalSize += pluginIndex.first;
+  }
+  monitor.StartLoadingPlugins(sizeMap.size(), totalSize);
+
+  // The snapshot resolves case differences between the main master file's
+  // name and the plugin names, like a case-insensitive filesystem would.
+  auto masterFile = snapshot.FindPlugin(masterFilename_);
+  auto loadPlugin = [&](PluginLoadResult& result, const DataFile& file) {
+    const auto& pluginName = file.name;
+    auto previousPlugin = FindFilename(previousPlugins, pluginName);
+
+    try {
+      const bool loadHeader =
+          loadHeadersOnly ||
+          (masterFile.has_value() && masterFile.value().path == file.path);
+
+      if (previousPlugin != previousPlugins.end() &&
+          IsPluginUnchanged(*previousPlugin->second, file, loadHeader)) {
+        keepPlugin(previousPlugin->second);
+        result.is_loaded = true;
+        return;
+      }
+
+      pluginsChanged = true;
+
+      if (!pluginDataCache || loadHeader) {
+        keepPlugin(std::make_shared<Plugin>(Type(), cache_, file, loadHeader));
+        result.is_loaded = true;
+        return;
+      }
+
+      // The file's key was read when the snapshot was taken, before the file
+      // is read, so if it changes while being read the data stored for it
+      // won't be reused.
+      const auto& key = file.key;
+
+      std::optional<PluginFileData> cachedData;
+      if (key.has_value()) {
+        cachedData = pluginDataCache->Find(file.path, key.value());
+      }
+
+      auto plugin = std::make_shared<Plugin>(
+          Type(), cache_, file, loadHeader, cachedData);
+      if (key.has_value() && !cachedData.has_value()) {
+        pluginDataCache->Insert(
+            file.path,
+            key.value(),
+            PluginFileData{plugin->GetCRC().value(),
+                           plugin->NumOverrideFormIDs()});
+      }
+
+      keepPlugin(plugin);
+      result.is_loaded = true;
+    } catch (std::exception& e) {
+      if (logger) {
+        logger->error(
+            "Caught exception while trying to add {} to the cache: {}",
+            pluginName,
+            e.what());
+      }
+      result.error_message = e.what();
+
+      if (previousPlugin != previousPlugins.end()) {
+        pluginsChanged = true;
+      }
+    }
+  };
+
+  vector<std::function<void()>> tasks;
+  for (auto it = sizeMap.rbegin(); it != sizeMap.rend(); ++it) {
+    // Each task writes only to its own result, so they don't need to be
+    // synchronised.
+    auto& result = results[it->second];
+    const auto& file = files[it->second];
+    const auto fileSize = it->first;
+    tasks.push_back([&, fileSize]() {
+      // If the operation is cancelled, plugins that are already being loaded
+      // are finished, but no more are started. Previously-loaded plugins
+      // are kept so that they can be reused by the next incremental load.
+      if (monitor.IsCancelled()) {
+        result.error_message = "Loading was cancelled.";
+
+        auto previousPlugin = FindFilename(previousPlugins, file.name);
+        if (previousPlugin != previousPlugins.end()) {
+          keepPlugin(previousPlugin->second);
         }
+        return;
       }
-    }));
+
+      loadPlugin(result, file);
+      monitor.PluginLoaded(fileSize);
+    });
+  }
+
+  threadPool->Run(tasks);
+
+  cache_->SetPlugins(std::move(loadedPluginsByName));
+
+  if (pluginDataCache) {
+    pluginDataCache->Save();
   }
 
-  // Join all threads.
-  for (auto& thread : threads) {
-    if (thread.joinable())
-      thread.join();
+  // The condition evaluator's state can only be replaced as a whole, but if
+  // no plugins have changed it can be left alone, which also keeps its cache
+  // of condition results.
+  if (pluginsChanged) {
+    conditionEvaluator_->RefreshState(cache_);
   }
 
-  conditionEvaluator_->RefreshState(cache_);
+  // Plugins loaded before cancellation are kept, as they were loaded
+  // successfully and can be reused by an incremental load.
+  monitor.ThrowIfCancelled();
+
+  return results;
 }
 
 std::shared_ptr<const PluginInterface> Game::GetPlugin(
@@ -203,7 +443,8 @@ std::shared_ptr<const PluginInterface> Game::GetPlugin(
 std::set<std::shared_ptr<const PluginInterface>> Game::GetLoadedPlugins()
     const {
   std::set<std::shared_ptr<const PluginInterface>> interfacePointers;
-  for (auto& plugin : cache_->GetPlugins()) {
+  auto snapshot = cache_->GetPluginsSnapshot();
+  for (auto& plugin : snapshot->plugins) {
     interfacePointers.insert(
         std::static_pointer_cast<const PluginInterface>(plugin));
   }
@@ -211,16 +452,108 @@ std::set<std::shared_ptr<const PluginInterface>> Game::GetLoadedPlugins()
   return interfacePointers;
 }
 
+void Game::SetThreadCount(size_t threadCount) {
+  std::lock_guard<std::mutex> guard(operationMutex_);
+  threadCount_ = threadCount;
+}
+
 void Game::IdentifyMainMasterFile(const std::string& masterFile) {
   masterFilename_ = masterFile;
 }
 
+void Game::SetSortingEngine(SortingEngine engine) { sortingEngine_ = engine; }
+
+void Game::SetSortCachePath(const std::filesystem::path& cachePath) {
+  sortCachePath_ = cachePath;
+}
+
+void Game::SetIncrementalPluginLoading(bool incremental) {
+  incrementalPluginLoading_ = incremental;
+}
+
+void Game::SetPluginDataCacheDirectory(
+    const std::filesystem::path& directory) {
+  pluginDataCacheDirectory_ = directory;
+}
+
 std::vector<std::string> Game::SortPlugins(
     const std::vector<std::string>& plugins) {
-  LoadPlugins(plugins, false);
+  std::lock_guard<std::mutex> guard(operationMutex_);
+
+  OperationMonitor monitor;
+  return SortPlugins(plugins, monitor);
+}
+
+std::future<std::vector<std::string>> Game::SortPluginsAsync(
+    const std::vector<std::string>& plugins,
+    ProgressCallback progressCallback,
+    std::shared_ptr<const CancellationToken> cancellationToken) {
+  return std::async(
+      std::launch::async,
+      [this, plugins, progressCallback, cancellationToken]() {
+        std::lock_guard<std::mutex> guard(operationMutex_);
+
+        OperationMonitor monitor(progressCallback, cancellationToken);
+        monitor.ThrowIfCancelled();
+        return SortPlugins(plugins, monitor);
+      });
+}
+
+std::vector<std::string> Game::SortPlugins(
+    const std::vector<std::string>& plugins,
+    OperationMonitor& monitor) {
+  const auto start = std::chrono::steady_clock::now();
+  sortStatistics_ = SortStatistics();
+
+  auto recordTotalDuration = [&]() {
+    sortStatistics_.total_duration =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start);
+  };
+
+  try {
+    LoadPlugins(plugins, false, monitor);
+    sortStatistics_.load_plugins_duration =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start);
+
+    std::vector<std::string> sortedPlugins;
+    if (sortCachePath_.empty()) {
+      // Sort plugins into their load order.
+      sortedPlugins =
+          loot::SortPlugins(*this, plugins, sortStatistics_, monitor);
+    } else {
+      auto fingerprint = GetSortFingerprint(*this, plugins);
+      auto cachedResult = ReadCachedSortResult(sortCachePath_, fingerprint);
+      if (cachedResult.has_value()) {
+        auto logger = getLogger();
+        if (logger) {
+          logger->info(
+              "Sorting inputs are unchanged, using cached load order.");
+        }
+        sortStatistics_.used_cached_result = true;
+        sortedPlugins = cachedResult.value();
+      } else {
+        // Sort plugins into their load order.
+        sortedPlugins =
+            loot::SortPlugins(*this, plugins, sortStatistics_, monitor);
+
+        WriteCachedSortResult(sortCachePath_, fingerprint, sortedPlugins);
+      }
+    }
 
-  // Sort plugins into their load order.
-  return loot::SortPlugins(*this, plugins);
+    recordTotalDuration();
+
+    return sortedPlugins;
+  } catch (...) {
+    recordTotalDuration();
+    throw;
+  }
+}
+
+SortStatistics Game::GetSortStatistics() const {
+  std::lock_guard<std::mutex> guard(operationMutex_);
+  return sortStatistics_;
 }
 
 void Game::LoadCurrentLoadOrderState() {
@@ -240,20 +573,13 @@ void Game::SetLoadOrder(const std::vector<std::string>& loadOrder) {
   loadOrderHandler_->SetLoadOrder(loadOrder);
 }
 
-void Game::CacheArchives() {
-  const auto archiveFileExtension = GetArchiveFileExtension(Type());
-
-  for (std::filesystem::directory_iterator it(DataPath());
-       it != std::filesystem::directory_iterator();
-       ++it) {
-    // Check if the path is an archive by checking if replacing its
-    // file extension with the archive extension resolves to the same file.
-    // Could use boost::iends_with, but it's less obvious here that the
-    // test string is ASCII-only.
-    if (loot::equivalent(it->path(),
-                         replaceExtension(it->path(), archiveFileExtension))) {
-      cache_->CacheArchivePath(it->path());
-    }
+void Game::CacheArchives(const DataDirectorySnapshot& snapshot) {
+  // Extensions are compared case-insensitively so that archives are found
+  // using the same matching as plugins use to find the archives they load.
+  auto archivePaths =
+      snapshot.GetPathsWithExtension(GetArchiveFileExtension(Type()));
+  for (const auto& archivePath : archivePaths) {
+    cache_->CacheArchivePath(archivePath);
   }
 }
 }
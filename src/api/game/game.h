@@ -25,11 +25,17 @@
 #ifndef LOOT_API_GAME_GAME
 #define LOOT_API_GAME_GAME
 
+#include <atomic>
 #include <filesystem>
+#include <future>
+#include <mutex>
 #include <string>
 
+#include "api/game/data_directory_snapshot.h"
 #include "api/game/game_cache.h"
 #include "api/game/load_order_handler.h"
+#include "api/helpers/operation_monitor.h"
+#include "api/helpers/thread_pool.h"
 #include "api/metadata/condition_evaluator.h"
 #include "loot/game_interface.h"
 
@@ -49,6 +55,19 @@ public:
   std::shared_ptr<GameCache> GetCache();
   std::shared_ptr<LoadOrderHandler> GetLoadOrderHandler();
 
+  SortingEngine GetSortingEngine() const;
+  size_t GetThreadCount() const;
+
+  // Gets the pool used to spread plugin loading and sorting work across
+  // GetThreadCount() threads. If the thread count has changed, a new pool is
+  // created, but callers that still hold the old pool keep it alive until
+  // they release it.
+  std::shared_ptr<ThreadPool> GetThreadPool();
+
+  // Get the snapshot of the data directory that was taken when plugins were
+  // last loaded, or take one if plugins haven't been loaded.
+  std::shared_ptr<const DataDirectorySnapshot> GetDataDirectorySnapshot();
+
   // Game Interface Methods //
   ////////////////////////////
 
@@ -59,15 +78,42 @@ public:
   void LoadPlugins(const std::vector<std::string>& plugins,
                    bool loadHeadersOnly);
 
+  std::vector<PluginLoadResult> TryLoadPlugins(
+      const std::vector<std::string>& plugins,
+      bool loadHeadersOnly);
+
+  std::future<void> LoadPluginsAsync(
+      const std::vector<std::string>& plugins,
+      bool loadHeadersOnly,
+      ProgressCallback progressCallback,
+      std::shared_ptr<const CancellationToken> cancellationToken);
+
   std::shared_ptr<const PluginInterface> GetPlugin(
       const std::string& pluginName) const;
 
   std::set<std::shared_ptr<const PluginInterface>> GetLoadedPlugins() const;
 
+  void SetThreadCount(size_t threadCount);
+
   void IdentifyMainMasterFile(const std::string& masterFile);
 
+  void SetSortingEngine(SortingEngine engine);
+
+  void SetSortCachePath(const std::filesystem::path& cachePath);
+
+  void SetPluginDataCacheDirectory(const std::filesystem::path& directory);
+
+  void SetIncrementalPluginLoading(bool incremental);
+
   std::vector<std::string> SortPlugins(const std::vector<std::string>& plugins);
 
+  std::future<std::vector<std::string>> SortPluginsAsync(
+      const std::vector<std::string>& plugins,
+      ProgressCallback progressCallback,
+      std::shared_ptr<const CancellationToken> cancellationToken);
+
+  SortStatistics GetSortStatistics() const;
+
   void LoadCurrentLoadOrderState();
 
   bool IsPluginActive(const std::string& pluginName) const;
@@ -77,7 +123,18 @@ public:
   void SetLoadOrder(const std::vector<std::string>& loadOrder);
 
 private:
-  void CacheArchives();
+  std::shared_ptr<const DataDirectorySnapshot> TakeDataDirectorySnapshot();
+  void LoadPlugins(const std::vector<std::string>& plugins,
+                   bool loadHeadersOnly,
+                   OperationMonitor& monitor);
+  std::vector<std::string> SortPlugins(const std::vector<std::string>& plugins,
+                                       OperationMonitor& monitor);
+  std::vector<PluginLoadResult> LoadPluginFiles(
+      const std::vector<std::string>& plugins,
+      bool loadHeadersOnly,
+      const DataDirectorySnapshot& snapshot,
+      OperationMonitor& monitor);
+  void CacheArchives(const DataDirectorySnapshot& snapshot);
 
   std::shared_ptr<GameCache> cache_;
   std::shared_ptr<LoadOrderHandler> loadOrderHandler_;
@@ -88,6 +145,23 @@ private:
   const std::filesystem::path gamePath_;
 
   std::string masterFilename_;
+  SortingEngine sortingEngine_;
+  // Atomic so that it can be read without waiting for an operation to end.
+  std::atomic<size_t> threadCount_;
+  std::shared_ptr<ThreadPool> threadPool_;
+  std::mutex threadPoolMutex_;
+  std::shared_ptr<const DataDirectorySnapshot> dataDirectorySnapshot_;
+  std::filesystem::path sortCachePath_;
+  std::filesystem::path pluginDataCacheDirectory_;
+  bool incrementalPluginLoading_;
+  SortStatistics sortStatistics_;
+
+  // Held for the duration of each plugin loading or sorting operation,
+  // whether it is asynchronous or not, so that operations run one at a time
+  // and don't share the thread pool, data directory snapshot or sort
+  // statistics. Also held while the thread count or sort statistics are
+  // accessed.
+  mutable std::mutex operationMutex_;
 };
 }
 #endif
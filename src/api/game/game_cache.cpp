@@ -24,7 +24,8 @@
 
 #include "api/game/game_cache.h"
 
-#include <thread>
+#include <algorithm>
+#include <atomic>
 
 #include "api/helpers/text.h"
 
@@ -34,56 +35,91 @@ using std::pair;
 using std::string;
 
 namespace loot {
-GameCache::GameCache() {}
+std::shared_ptr<const PluginsSnapshot> MakePluginsSnapshot(
+    PluginsByName plugins) {
+  auto snapshot = std::make_shared<PluginsSnapshot>();
+  std::transform(
+      begin(plugins),
+      end(plugins),
+      std::inserter<std::set<std::shared_ptr<const Plugin>>>(
+          snapshot->plugins, begin(snapshot->plugins)),
+      [](const pair<FilenameKey, std::shared_ptr<const Plugin>>& pluginPair) {
+        return pluginPair.second;
+      });
+  snapshot->pluginsByName = std::move(plugins);
+
+  return snapshot;
+}
+
+GameCache::GameCache() :
+    pluginsSnapshot_(std::make_shared<const PluginsSnapshot>()) {}
 
 GameCache::GameCache(const GameCache& cache) :
-    plugins_(cache.plugins_) {}
+    pluginsSnapshot_(std::atomic_load(&cache.pluginsSnapshot_)) {}
 
 GameCache& GameCache::operator=(const GameCache& cache) {
   if (&cache != this) {
-    plugins_ = cache.plugins_;
+    lock_guard<mutex> lock(mutex_);
+
+    std::atomic_store(&pluginsSnapshot_,
+                      std::atomic_load(&cache.pluginsSnapshot_));
   }
 
   return *this;
 }
 
+std::shared_ptr<const PluginsSnapshot> GameCache::GetPluginsSnapshot() const {
+  return std::atomic_load(&pluginsSnapshot_);
+}
+
 std::set<std::shared_ptr<const Plugin>> GameCache::GetPlugins() const {
-  std::set<std::shared_ptr<const Plugin>> output;
-  std::transform(
-      begin(plugins_),
-      end(plugins_),
-      std::inserter<std::set<std::shared_ptr<const Plugin>>>(output,
-                                                             begin(output)),
-      [](const pair<string, std::shared_ptr<const Plugin>>& pluginPair) {
-        return pluginPair.second;
-      });
-  return output;
+  // Copying a set copies its tree structure, so no plugins are compared.
+  return GetPluginsSnapshot()->plugins;
 }
 
 std::shared_ptr<const Plugin> GameCache::GetPlugin(
     const std::string& pluginName) const {
-  auto it = plugins_.find(NormalizeFilename(pluginName));
-  if (it != end(plugins_))
+  auto snapshot = GetPluginsSnapshot();
+
+  auto it = FindFilename(snapshot->pluginsByName, pluginName);
+  if (it != end(snapshot->pluginsByName))
     return it->second;
 
   return nullptr;
 }
 
-void GameCache::AddPlugin(const Plugin&& plugin) {
+std::shared_ptr<const Plugin> GameCache::GetPlugin(
+    const FilenameKey& pluginKey) const {
+  auto snapshot = GetPluginsSnapshot();
+
+  auto it = snapshot->pluginsByName.find(pluginKey);
+  if (it != end(snapshot->pluginsByName))
+    return it->second;
+
+  return nullptr;
+}
+
+void GameCache::SetPlugins(PluginsByName plugins) {
+  auto snapshot = MakePluginsSnapshot(std::move(plugins));
+
   lock_guard<mutex> lock(mutex_);
+  std::atomic_store(&pluginsSnapshot_, snapshot);
+}
 
-  auto normalizedName = NormalizeFilename(plugin.GetName());
+void GameCache::AddPlugin(const Plugin&& plugin) {
+  auto newPlugin = std::make_shared<Plugin>(std::move(plugin));
 
-  auto it = plugins_.find(normalizedName);
-  if (it != end(plugins_))
-    plugins_.erase(it);
+  lock_guard<mutex> lock(mutex_);
 
-  plugins_.emplace(normalizedName,
-                   std::make_shared<Plugin>(std::move(plugin)));
+  auto plugins = std::atomic_load(&pluginsSnapshot_)->pluginsByName;
+  plugins.insert_or_assign(newPlugin->GetFilenameKey(), newPlugin);
+  std::atomic_store(&pluginsSnapshot_, MakePluginsSnapshot(std::move(plugins)));
 }
 
 std::set<std::filesystem::path> GameCache::GetArchivePaths() const
 {
+  lock_guard<mutex> lock(mutex_);
+
   return archivePaths_;
 }
 
@@ -92,17 +128,40 @@ void GameCache::CacheArchivePath(const std::filesystem::path& path)
   lock_guard<mutex> lock(mutex_);
 
   archivePaths_.insert(path);
+  archiveFilenames_.insert(NormalizeFilename(path.filename().u8string()));
+}
+
+bool GameCache::HasArchive(const std::string& filename) const {
+  auto normalizedFilename = NormalizeFilename(filename);
+
+  lock_guard<mutex> lock(mutex_);
+  return archiveFilenames_.count(normalizedFilename) != 0;
+}
+
+bool GameCache::HasArchiveWithPrefix(const std::string& filenamePrefix) const {
+  // Filenames that start with the prefix sort together, beginning with the
+  // first filename that is not less than the prefix, so only that filename
+  // needs to be checked.
+  auto normalizedPrefix = NormalizeFilename(filenamePrefix);
+
+  lock_guard<mutex> lock(mutex_);
+  auto it = archiveFilenames_.lower_bound(normalizedPrefix);
+
+  return it != archiveFilenames_.end() &&
+         it->compare(0, normalizedPrefix.length(), normalizedPrefix) == 0;
 }
 
 void GameCache::ClearCachedPlugins() {
   lock_guard<mutex> guard(mutex_);
 
-  plugins_.clear();
+  std::atomic_store(&pluginsSnapshot_,
+                    std::make_shared<const PluginsSnapshot>());
 }
 
 void GameCache::ClearCachedArchivePaths() {
   lock_guard<mutex> guard(mutex_);
 
   archivePaths_.clear();
+  archiveFilenames_.clear();
 }
 }
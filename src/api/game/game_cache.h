@@ -25,13 +25,45 @@
 #ifndef LOOT_API_GAME_GAME_CACHE
 #define LOOT_API_GAME_GAME_CACHE
 
+#include <memory>
 #include <mutex>
+#include <set>
 #include <string>
 #include <unordered_map>
 
 #include "api/plugin.h"
 
+namespace std {
+template<>
+struct less<std::shared_ptr<const loot::Plugin>> {
+  bool operator()(const std::shared_ptr<const loot::Plugin>& lhs,
+                  const std::shared_ptr<const loot::Plugin>& rhs) const {
+    if (!lhs) {
+      return false;
+    }
+
+    if (!rhs) {
+      return true;
+    }
+
+    return *lhs < *rhs;
+  }
+};
+}
+
 namespace loot {
+typedef std::unordered_map<FilenameKey, std::shared_ptr<const Plugin>>
+    PluginsByName;
+
+// An immutable view of the plugins that were cached at one point in time.
+// It is never modified once created, so it can be read from any number of
+// threads without locking.
+struct PluginsSnapshot {
+  // Sorted by filename.
+  std::set<std::shared_ptr<const Plugin>> plugins;
+  PluginsByName pluginsByName;
+};
+
 class GameCache {
 public:
   explicit GameCache();
@@ -39,40 +71,43 @@ public:
 
   GameCache& operator=(const GameCache& cache);
 
+  // Unlike GetPlugins(), this doesn't copy anything. A new snapshot is
+  // published each time the cached plugins change, and reading the current
+  // snapshot never blocks.
+  std::shared_ptr<const PluginsSnapshot> GetPluginsSnapshot() const;
   std::set<std::shared_ptr<const Plugin>> GetPlugins() const;
   std::shared_ptr<const Plugin> GetPlugin(const std::string& pluginName) const;
+  std::shared_ptr<const Plugin> GetPlugin(const FilenameKey& pluginKey) const;
+
+  // Replaces all the cached plugins, publishing a single new snapshot. Use
+  // this to cache many plugins at once, as AddPlugin() copies the current
+  // snapshot.
+  void SetPlugins(PluginsByName plugins);
   void AddPlugin(const Plugin&& plugin);
 
   std::set<std::filesystem::path> GetArchivePaths() const;
   void CacheArchivePath(const std::filesystem::path& path);
 
+  // Check if there is a cached archive with the given filename, or with a
+  // filename that starts with the given prefix. Filenames are compared
+  // case-insensitively, without accessing the filesystem.
+  bool HasArchive(const std::string& filename) const;
+  bool HasArchiveWithPrefix(const std::string& filenamePrefix) const;
+
   void ClearCachedPlugins();
   void ClearCachedArchivePaths();
 
 private:
-  std::unordered_map<std::string, std::shared_ptr<const Plugin>> plugins_;
+  // Only accessed using the atomic shared_ptr functions. Never null.
+  std::shared_ptr<const PluginsSnapshot> pluginsSnapshot_;
   std::set<std::filesystem::path> archivePaths_;
+  // Normalised archive filenames, sorted so that all filenames that start
+  // with a given prefix are adjacent.
+  std::set<std::string> archiveFilenames_;
 
+  // Serialises changes to the cached plugins, and guards the archive data.
   mutable std::mutex mutex_;
 };
 }
 
-namespace std {
-template<>
-struct less<std::shared_ptr<const loot::Plugin>> {
-  bool operator()(const std::shared_ptr<const loot::Plugin>& lhs,
-                  const std::shared_ptr<const loot::Plugin>& rhs) const {
-    if (!lhs) {
-      return false;
-    }
-
-    if (!rhs) {
-      return true;
-    }
-
-    return *lhs < *rhs;
-  }
-};
-}
-
 #endif
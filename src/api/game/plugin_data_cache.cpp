@@ -0,0 +1,251 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "api/game/plugin_data_cache.h"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+#include "api/helpers/crc.h"
+#include "api/helpers/logging.h"
+#include "api/helpers/text.h"
+#include "loot/loot_version.h"
+
+namespace loot {
+static constexpr const char* CACHE_FILENAME = "plugin_data_cache.txt";
+static constexpr const char* CACHE_FORMAT_LINE = "LOOT plugin data cache v1";
+
+// Cached data depends on how the version of libloot that wrote it counted
+// override records, so the cache is only valid for that version.
+std::string GetCacheVersionLine() {
+  return "libloot " + LootVersion::GetVersionString();
+}
+
+// Filesystem timestamps can be coarser than the time taken to write a file,
+// so a file could be changed again without its modification time changing.
+// Don't cache data for files modified this recently, as git does for its
+// index.
+static constexpr std::chrono::seconds RACY_MODIFICATION_WINDOW(2);
+
+bool PluginFileKey::operator==(const PluginFileKey& rhs) const {
+  return size == rhs.size && modificationTime == rhs.modificationTime &&
+         fileId == rhs.fileId;
+}
+
+PluginDataCache::PluginDataCache(const std::filesystem::path& cacheDirectory) :
+    cacheDirectory_(cacheDirectory),
+    isModified_(false) {
+  Read();
+}
+
+std::optional<PluginFileKey> PluginDataCache::GetFileKey(
+    const std::filesystem::path& pluginPath) {
+  std::error_code errorCode;
+  PluginFileKey key;
+
+  key.size = std::filesystem::file_size(pluginPath, errorCode);
+  if (errorCode) {
+    return std::nullopt;
+  }
+
+  auto modificationTime =
+      std::filesystem::last_write_time(pluginPath, errorCode);
+  if (errorCode) {
+    return std::nullopt;
+  }
+  key.modificationTime = modificationTime.time_since_epoch().count();
+
+#ifdef _WIN32
+  // std::filesystem doesn't expose file IDs, but NTFS records modification
+  // times with 100 ns precision, so the size and time are enough.
+  key.fileId = 0;
+#else
+  // The inode number changes when a file is replaced rather than modified,
+  // which some tools do while preserving the original modification time.
+  struct stat status;
+  if (stat(pluginPath.c_str(), &status) != 0) {
+    return std::nullopt;
+  }
+  key.fileId = (uint64_t)status.st_ino;
+#endif
+
+  return key;
+}
+
+std::optional<PluginFileData> PluginDataCache::Find(
+    const std::filesystem::path& pluginPath,
+    const PluginFileKey& key) const {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  auto it = entries_.find(NormalizeFilename(pluginPath.u8string()));
+  if (it == entries_.end() || !(it->second.key == key)) {
+    return std::nullopt;
+  }
+
+  return it->second.data;
+}
+
+void PluginDataCache::Insert(const std::filesystem::path& pluginPath,
+                             const PluginFileKey& key,
+                             const PluginFileData& data) {
+  using std::chrono::duration_cast;
+  using std::filesystem::file_time_type;
+
+  auto now = file_time_type::clock::now().time_since_epoch().count();
+  auto window =
+      duration_cast<file_time_type::duration>(RACY_MODIFICATION_WINDOW)
+          .count();
+  if (now - key.modificationTime < window) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  entries_[NormalizeFilename(pluginPath.u8string())] = Entry{key, data};
+  isModified_ = true;
+}
+
+void PluginDataCache::Save() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  if (!isModified_) {
+    return;
+  }
+
+  std::ostringstream body;
+  for (const auto& entry : entries_) {
+    body << entry.second.key.size << ' ' << entry.second.key.modificationTime
+         << ' ' << entry.second.key.fileId << ' ' << std::hex
+         << entry.second.data.crc << std::dec << ' '
+         << entry.second.data.overrideRecordCount << ' ' << entry.first
+         << '\n';
+  }
+  auto bodyString = body.str();
+  auto checksum = UpdateCrc32(0, bodyString.data(), bodyString.size());
+
+  auto cachePath = cacheDirectory_ / CACHE_FILENAME;
+  auto tempPath = cachePath;
+  tempPath += ".tmp";
+
+  // Write to a temporary file first so that an interrupted write can't
+  // replace a valid cache file with a partial one.
+  std::error_code errorCode;
+  std::filesystem::create_directories(cacheDirectory_, errorCode);
+
+  std::ofstream out(tempPath, std::ios::binary);
+  out << CACHE_FORMAT_LINE << '\n'
+      << GetCacheVersionLine() << '\n'
+      << std::hex << checksum << std::dec << '\n'
+      << bodyString;
+  out.close();
+
+  if (out.good()) {
+    std::filesystem::rename(tempPath, cachePath, errorCode);
+  }
+
+  if (!out.good() || errorCode) {
+    auto logger = getLogger();
+    if (logger) {
+      logger->warn("Failed to write the plugin data cache file at \"{}\"",
+                   cachePath.u8string());
+    }
+    std::filesystem::remove(tempPath, errorCode);
+  }
+}
+
+void PluginDataCache::Read() {
+  auto cachePath = cacheDirectory_ / CACHE_FILENAME;
+  std::ifstream in(cachePath, std::ios::binary);
+  if (!in.good()) {
+    return;
+  }
+
+  auto logger = getLogger();
+  auto discard = [&](const std::string& reason) {
+    if (logger) {
+      logger->warn(
+          "Ignoring the plugin data cache file at \"{}\" because {}",
+          cachePath.u8string(),
+          reason);
+    }
+    entries_.clear();
+  };
+
+  std::string line;
+  if (!std::getline(in, line) || line != CACHE_FORMAT_LINE) {
+    discard("its format is not recognised.");
+    return;
+  }
+
+  if (!std::getline(in, line) || line != GetCacheVersionLine()) {
+    if (logger) {
+      logger->debug(
+          "Ignoring the plugin data cache file at \"{}\" because it was "
+          "written by a different version of libloot.",
+          cachePath.u8string());
+    }
+    return;
+  }
+
+  uint32_t expectedChecksum = 0;
+  if (!std::getline(in, line) ||
+      !(std::istringstream(line) >> std::hex >> expectedChecksum)) {
+    discard("it has no checksum.");
+    return;
+  }
+
+  std::string body((std::istreambuf_iterator<char>(in)),
+                   std::istreambuf_iterator<char>());
+  if (UpdateCrc32(0, body.data(), body.size()) != expectedChecksum) {
+    discard("its checksum does not match its content.");
+    return;
+  }
+
+  std::istringstream bodyStream(body);
+  while (std::getline(bodyStream, line)) {
+    std::istringstream lineStream(line);
+    Entry entry;
+    std::string path;
+
+    lineStream >> entry.key.size >> entry.key.modificationTime >>
+        entry.key.fileId >> std::hex >> entry.data.crc >> std::dec >>
+        entry.data.overrideRecordCount;
+
+    // The path is last so that it may contain spaces.
+    if (!lineStream || lineStream.get() != ' ' ||
+        !std::getline(lineStream, path) || path.empty()) {
+      discard("it contains an invalid entry.");
+      return;
+    }
+
+    entries_.emplace(path, entry);
+  }
+}
+}
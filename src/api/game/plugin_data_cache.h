@@ -0,0 +1,95 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_API_GAME_PLUGIN_DATA_CACHE
+#define LOOT_API_GAME_PLUGIN_DATA_CACHE
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace loot {
+// The filesystem metadata that a cached entry is valid for. If any of these
+// change, the file is assumed to have changed.
+struct PluginFileKey {
+  uintmax_t size;
+  int64_t modificationTime;
+  uint64_t fileId;
+
+  bool operator==(const PluginFileKey& rhs) const;
+};
+
+// The data that is expensive to calculate when loading a plugin, but which
+// only depends on the plugin file's content.
+struct PluginFileData {
+  uint32_t crc;
+  size_t overrideRecordCount;
+};
+
+// A cache of plugin file data that is persisted between sessions. Entries are
+// keyed by the plugin's normalised path, and are only returned if the file's
+// size, modification time and file ID are unchanged.
+class PluginDataCache {
+public:
+  // Reads the cache file in the given directory, if it exists. If the file
+  // can't be read or is corrupt, the cache starts empty.
+  explicit PluginDataCache(const std::filesystem::path& cacheDirectory);
+
+  // Returns nullopt if the file's metadata can't be read.
+  static std::optional<PluginFileKey> GetFileKey(
+      const std::filesystem::path& pluginPath);
+
+  std::optional<PluginFileData> Find(const std::filesystem::path& pluginPath,
+                                     const PluginFileKey& key) const;
+
+  // The key must have been obtained before the file was read to calculate
+  // the data, so that changes made while reading invalidate the entry.
+  void Insert(const std::filesystem::path& pluginPath,
+              const PluginFileKey& key,
+              const PluginFileData& data);
+
+  // Writes the cache file if any entries have been inserted. Failure to write
+  // is logged but otherwise ignored.
+  void Save() const;
+
+private:
+  struct Entry {
+    PluginFileKey key;
+    PluginFileData data;
+  };
+
+  void Read();
+
+  std::filesystem::path cacheDirectory_;
+  std::map<std::string, Entry> entries_;
+  bool isModified_;
+
+  mutable std::mutex mutex_;
+};
+}
+
+#endif
@@ -24,27 +24,336 @@
 
 #include "api/helpers/crc.h"
 
+#include <array>
+#include <cerrno>
 #include <fstream>
+#include <system_error>
+#include <vector>
 
-#include <boost/crc.hpp>
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || \
+    defined(_M_IX86)
+#define LOOT_CRC32_X86
+#include <emmintrin.h>
+#include <smmintrin.h>
+#include <wmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 #include "api/helpers/logging.h"
 
 #include "loot/exception/file_access_error.h"
 
-using std::string;
-using std::wstring;
-
 namespace loot {
-size_t GetStreamSize(std::istream& stream) {
-  std::streampos startingPosition = stream.tellg();
+typedef std::array<std::array<uint32_t, 256>, 16> Crc32Tables;
+
+// The reflected CRC-32 polynomial.
+static constexpr uint32_t CRC32_POLYNOMIAL = 0xEDB88320;
+
+// The size of the buffer used to read files.
+static constexpr size_t CRC32_READ_BUFFER_SIZE = 1024 * 1024;
+
+// Tables for slicing-by-16: tables[0] is the usual bytewise table, and
+// tables[k][i] is the CRC of byte i followed by k zero bytes.
+const Crc32Tables& GetCrc32Tables() {
+  static const Crc32Tables tables = []() {
+    Crc32Tables tables;
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t crc = i;
+      for (int bit = 0; bit < 8; ++bit) {
+        crc = (crc >> 1) ^ ((crc & 1) ? CRC32_POLYNOMIAL : 0);
+      }
+      tables[0][i] = crc;
+    }
+
+    for (size_t k = 1; k < tables.size(); ++k) {
+      for (size_t i = 0; i < 256; ++i) {
+        const auto previous = tables[k - 1][i];
+        tables[k][i] = (previous >> 8) ^ tables[0][previous & 0xFF];
+      }
+    }
+
+    return tables;
+  }();
+
+  return tables;
+}
+
+uint32_t ReadUInt32LittleEndian(const unsigned char* bytes) {
+  return static_cast<uint32_t>(bytes[0]) |
+         (static_cast<uint32_t>(bytes[1]) << 8) |
+         (static_cast<uint32_t>(bytes[2]) << 16) |
+         (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+// Both CRC kernels work on the inverted CRC value, so that blocks can be
+// chained without inverting between them.
+uint32_t UpdateInvertedCrc32Portable(uint32_t crc,
+                                     const unsigned char* data,
+                                     size_t length) {
+  const auto& tables = GetCrc32Tables();
+
+  while (length >= 16) {
+    const uint32_t one = ReadUInt32LittleEndian(data) ^ crc;
+    const uint32_t two = ReadUInt32LittleEndian(data + 4);
+    const uint32_t three = ReadUInt32LittleEndian(data + 8);
+    const uint32_t four = ReadUInt32LittleEndian(data + 12);
+
+    crc = tables[15][one & 0xFF] ^ tables[14][(one >> 8) & 0xFF] ^
+          tables[13][(one >> 16) & 0xFF] ^ tables[12][one >> 24] ^
+          tables[11][two & 0xFF] ^ tables[10][(two >> 8) & 0xFF] ^
+          tables[9][(two >> 16) & 0xFF] ^ tables[8][two >> 24] ^
+          tables[7][three & 0xFF] ^ tables[6][(three >> 8) & 0xFF] ^
+          tables[5][(three >> 16) & 0xFF] ^ tables[4][three >> 24] ^
+          tables[3][four & 0xFF] ^ tables[2][(four >> 8) & 0xFF] ^
+          tables[1][(four >> 16) & 0xFF] ^ tables[0][four >> 24];
+
+    data += 16;
+    length -= 16;
+  }
+
+  while (length > 0) {
+    crc = (crc >> 8) ^ tables[0][(crc ^ *data) & 0xFF];
+    data += 1;
+    length -= 1;
+  }
+
+  return crc;
+}
+
+#ifdef LOOT_CRC32_X86
+#if defined(__GNUC__) || defined(__clang__)
+#define LOOT_CRC32_TARGET_PCLMUL __attribute__((target("pclmul,sse4.1")))
+#else
+#define LOOT_CRC32_TARGET_PCLMUL
+#endif
+
+bool IsPclmulSupported() {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+#elif defined(_MSC_VER)
+  int cpuInfo[4];
+  __cpuid(cpuInfo, 1);
+  const bool hasPclmul = (cpuInfo[2] & (1 << 1)) != 0;
+  const bool hasSse41 = (cpuInfo[2] & (1 << 19)) != 0;
+  return hasPclmul && hasSse41;
+#else
+  return false;
+#endif
+}
+
+// Folds 64-byte blocks using carry-less multiplication, then reduces the
+// result with a Barrett reduction, as described in Intel's "Fast CRC
+// Computation for Generic Polynomials Using PCLMULQDQ Instruction" paper.
+// Any data after the last whole 16-byte block is handled by the portable
+// kernel.
+LOOT_CRC32_TARGET_PCLMUL
+uint32_t UpdateInvertedCrc32Pclmul(uint32_t crc,
+                                   const unsigned char* data,
+                                   size_t length) {
+  if (length < 64) {
+    return UpdateInvertedCrc32Portable(crc, data, length);
+  }
+
+  alignas(16) static const uint64_t k1k2[] = {0x0154442bd4, 0x01c6e41596};
+  alignas(16) static const uint64_t k3k4[] = {0x01751997d0, 0x00ccaa009e};
+  alignas(16) static const uint64_t k5k0[] = {0x0163cd6124, 0x0000000000};
+  alignas(16) static const uint64_t poly[] = {0x01db710641, 0x01f7011641};
+
+  auto load = [](const unsigned char* bytes) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+  };
+
+  __m128i x1 = load(data);
+  __m128i x2 = load(data + 16);
+  __m128i x3 = load(data + 32);
+  __m128i x4 = load(data + 48);
+
+  x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(crc)));
+
+  __m128i x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k1k2));
+
+  data += 64;
+  length -= 64;
+
+  // Fold four 128-bit lanes in parallel.
+  while (length >= 64) {
+    const __m128i x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    const __m128i x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    const __m128i x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+    const __m128i x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+    x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+    x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), load(data));
+    x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), load(data + 16));
+    x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), load(data + 32));
+    x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), load(data + 48));
+
+    data += 64;
+    length -= 64;
+  }
+
+  // Fold the four lanes into one.
+  x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k3k4));
+
+  for (const auto& lane : {x2, x3, x4}) {
+    const __m128i x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, lane), x5);
+  }
+
+  // Fold in any remaining whole 16-byte blocks.
+  while (length >= 16) {
+    const __m128i x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, load(data)), x5);
 
-  stream.seekg(0, std::ios_base::end);
-  size_t streamSize = stream.tellg();
-  stream.seekg(startingPosition, std::ios_base::beg);
+    data += 16;
+    length -= 16;
+  }
+
+  // Fold 128 bits down to 64 bits.
+  const __m128i mask = _mm_setr_epi32(~0, 0, ~0, 0);
+  x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+  x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+
+  x0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(k5k0));
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_and_si128(x1, mask);
+  x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  // Barrett reduce to 32 bits.
+  x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(poly));
+  x2 = _mm_and_si128(x1, mask);
+  x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+  x2 = _mm_and_si128(x2, mask);
+  x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  crc = static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
+
+  return UpdateInvertedCrc32Portable(crc, data, length);
+}
+#endif
+
+typedef uint32_t (*Crc32Kernel)(uint32_t, const unsigned char*, size_t);
+
+Crc32Kernel GetCrc32Kernel() {
+  static const Crc32Kernel kernel = []() -> Crc32Kernel {
+#ifdef LOOT_CRC32_X86
+    if (IsPclmulSupported()) {
+      return UpdateInvertedCrc32Pclmul;
+    }
+#endif
+    return UpdateInvertedCrc32Portable;
+  }();
+
+  return kernel;
+}
+
+uint32_t UpdateCrc32(uint32_t crc, const void* data, size_t length) {
+  return ~GetCrc32Kernel()(
+      ~crc, static_cast<const unsigned char*>(data), length);
+}
+
+uint32_t UpdateCrc32Portable(uint32_t crc, const void* data, size_t length) {
+  return ~UpdateInvertedCrc32Portable(
+      ~crc, static_cast<const unsigned char*>(data), length);
+}
+
+bool IsCrc32HardwareAccelerated() {
+  return GetCrc32Kernel() != UpdateInvertedCrc32Portable;
+}
+
+#ifndef _WIN32
+class FileDescriptor {
+public:
+  explicit FileDescriptor(const std::filesystem::path& path) :
+      fd_(open(path.c_str(), O_RDONLY | O_CLOEXEC)) {
+    if (fd_ == -1) {
+      throw std::system_error(errno, std::generic_category());
+    }
+  }
 
-  return streamSize;
+  ~FileDescriptor() { close(fd_); }
+
+  FileDescriptor(const FileDescriptor&) = delete;
+  FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+  int Get() const { return fd_; }
+
+private:
+  const int fd_;
+};
+
+// Reads the file into a large buffer, telling the kernel that it will be read
+// sequentially so that it reads ahead aggressively. The file isn't
+// memory-mapped, because mod managers routinely rewrite plugins, and reading a
+// mapped file that another process has truncated raises SIGBUS instead of
+// failing the read.
+uint32_t GetCrc32OfFile(const std::filesystem::path& filename) {
+  FileDescriptor file(filename);
+
+#ifdef POSIX_FADV_SEQUENTIAL
+  posix_fadvise(file.Get(), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+  std::vector<char> buffer(CRC32_READ_BUFFER_SIZE);
+  uint32_t checksum = 0;
+  while (true) {
+    const auto bytesRead = read(file.Get(), buffer.data(), buffer.size());
+    if (bytesRead == 0) {
+      return checksum;
+    }
+    if (bytesRead < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::system_error(errno, std::generic_category());
+    }
+
+    checksum = UpdateCrc32(checksum, buffer.data(), bytesRead);
+  }
 }
+#else
+uint32_t GetCrc32OfStream(std::istream& stream) {
+  std::vector<char> buffer(CRC32_READ_BUFFER_SIZE);
+  uint32_t checksum = 0;
+  while (stream.read(buffer.data(), buffer.size()) || stream.gcount() > 0) {
+    checksum = UpdateCrc32(checksum, buffer.data(), stream.gcount());
+  }
+
+  if (stream.bad()) {
+    throw std::system_error(
+        std::make_error_code(std::errc::io_error), "Failed to read file");
+  }
+
+  return checksum;
+}
+
+uint32_t GetCrc32OfFile(const std::filesystem::path& filename) {
+  std::ifstream ifile(filename, std::ios::binary);
+  if (!ifile.is_open()) {
+    throw std::system_error(
+        std::make_error_code(std::errc::no_such_file_or_directory),
+        "Failed to open file");
+  }
+
+  return GetCrc32OfStream(ifile);
+}
+#endif
 
 // Calculate the CRC of the given file for comparison purposes.
 uint32_t GetCrc32(const std::filesystem::path& filename) {
@@ -54,24 +363,7 @@ uint32_t GetCrc32(const std::filesystem::path& filename) {
       logger->trace("Calculating CRC for: {}", filename.u8string());
     }
 
-    std::ifstream ifile(filename, std::ios::binary);
-    ifile.exceptions(std::ios_base::badbit | std::ios_base::failbit);
-
-    static const size_t bufferSize = 8192;
-    char buffer[bufferSize];
-    boost::crc_32_type result;
-    size_t bytesLeft = GetStreamSize(ifile);
-    while (bytesLeft > 0) {
-      if (bytesLeft > bufferSize)
-        ifile.read(buffer, bufferSize);
-      else
-        ifile.read(buffer, bytesLeft);
-
-      result.process_bytes(buffer, ifile.gcount());
-      bytesLeft -= ifile.gcount();
-    }
-
-    uint32_t checksum = result.checksum();
+    uint32_t checksum = GetCrc32OfFile(filename);
     if (logger) {
       auto u8Filename = filename.u8string();
       logger->debug("CRC32(\"{}\"): {:x}", u8Filename, checksum);
@@ -25,11 +25,24 @@
 #ifndef LOOT_API_HELPERS_CRC
 #define LOOT_API_HELPERS_CRC
 
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
 
 namespace loot {
 uint32_t GetCrc32(const std::filesystem::path& filename);
+
+// Update a CRC-32 (as used by zlib and Boost's crc_32_type) with the given
+// data. Pass 0 as the CRC for the first block of data. The fastest
+// implementation supported by the CPU is used.
+uint32_t UpdateCrc32(uint32_t crc, const void* data, size_t length);
+
+// The same as UpdateCrc32(), but always uses the portable table-driven
+// implementation.
+uint32_t UpdateCrc32Portable(uint32_t crc, const void* data, size_t length);
+
+// Returns true if UpdateCrc32() uses carry-less multiplication instructions.
+bool IsCrc32HardwareAccelerated();
 }
 
 #endif
@@ -0,0 +1,141 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "api/helpers/filename_key.h"
+
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+
+#include "api/helpers/text.h"
+
+namespace loot {
+struct FilenameTable {
+  // Most accesses only read the table, so they can share the lock.
+  std::shared_mutex mutex;
+  // The keys view the names held by their entries, so each name is only
+  // stored once.
+  std::unordered_map<std::string_view, std::unique_ptr<FilenameKey::Entry>>
+      entries;
+  // Entries keyed by the filenames that they were created from, so that
+  // looking up a filename with a spelling that has been seen before doesn't
+  // need to normalise it.
+  std::unordered_map<std::string, const FilenameKey::Entry*> spellings;
+};
+
+// The table is never destroyed, so keys held by other static objects remain
+// valid while those objects are destroyed.
+static FilenameTable& GetFilenameTable() {
+  static FilenameTable* table = new FilenameTable();
+  return *table;
+}
+
+static const FilenameKey::Entry* FindSpelling(FilenameTable& table,
+                                              const std::string& filename) {
+  std::shared_lock<std::shared_mutex> lock(table.mutex);
+
+  auto it = table.spellings.find(filename);
+  return it == table.spellings.end() ? nullptr : it->second;
+}
+
+static const FilenameKey::Entry* FindNormalizedName(
+    FilenameTable& table,
+    const std::string& normalizedName) {
+  std::shared_lock<std::shared_mutex> lock(table.mutex);
+
+  auto it = table.entries.find(normalizedName);
+  return it == table.entries.end() ? nullptr : it->second.get();
+}
+
+static const FilenameKey::Entry* Intern(const std::string& filename) {
+  auto& table = GetFilenameTable();
+
+  auto entry = FindSpelling(table, filename);
+  if (entry != nullptr) {
+    return entry;
+  }
+
+  // Normalise without holding the lock.
+  auto normalizedName = NormalizeFilename(filename);
+
+  std::unique_lock<std::shared_mutex> lock(table.mutex);
+
+  // Another thread may have added the name while the lock was released.
+  auto it = table.entries.find(normalizedName);
+  if (it == table.entries.end()) {
+    auto newEntry = std::make_unique<FilenameKey::Entry>();
+    newEntry->id = static_cast<uint32_t>(table.entries.size());
+    newEntry->normalizedName = std::move(normalizedName);
+
+    std::string_view name = newEntry->normalizedName;
+    it = table.entries.emplace(name, std::move(newEntry)).first;
+  }
+
+  table.spellings.emplace(filename, it->second.get());
+
+  return it->second.get();
+}
+
+FilenameKey::FilenameKey() : entry_(Intern("")) {}
+
+FilenameKey::FilenameKey(const std::string& filename) :
+    entry_(Intern(filename)) {}
+
+FilenameKey::FilenameKey(const Entry* entry) : entry_(entry) {}
+
+std::optional<FilenameKey> FilenameKey::Find(const std::string& filename) {
+  auto& table = GetFilenameTable();
+
+  auto entry = FindSpelling(table, filename);
+  if (entry == nullptr) {
+    entry = FindNormalizedName(table, NormalizeFilename(filename));
+  }
+
+  if (entry == nullptr) {
+    return std::nullopt;
+  }
+
+  return FilenameKey(entry);
+}
+
+uint32_t FilenameKey::GetId() const { return entry_->id; }
+
+const std::string& FilenameKey::GetNormalizedName() const {
+  return entry_->normalizedName;
+}
+
+bool FilenameKey::operator==(const FilenameKey& rhs) const {
+  return entry_ == rhs.entry_;
+}
+
+bool FilenameKey::operator!=(const FilenameKey& rhs) const {
+  return entry_ != rhs.entry_;
+}
+
+bool FilenameKey::operator<(const FilenameKey& rhs) const {
+  return entry_->id < rhs.entry_->id;
+}
+}
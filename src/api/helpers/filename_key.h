@@ -0,0 +1,102 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_API_HELPERS_FILENAME_KEY
+#define LOOT_API_HELPERS_FILENAME_KEY
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+
+namespace loot {
+// A filename that has been normalised and stored once in a process-wide
+// table, so that keys for filenames that differ only in case are the same
+// object. Comparing and hashing keys only compares and hashes their IDs, so
+// containers keyed by filename don't need to normalise or compare strings
+// once their keys have been created.
+//
+// The table lives until the process exits, and entries are never removed, so
+// it holds each distinct filename (and each spelling of it) that keys have
+// been created for. Keys are created for loaded plugins, their masters and
+// metadata entries, so use Find() to look up other filenames without adding
+// them to the table.
+class FilenameKey {
+public:
+  // The key for an empty filename.
+  FilenameKey();
+  explicit FilenameKey(const std::string& filename);
+
+  // Gets the key for the given filename if one has already been created.
+  // Containers keyed by filename can't hold a filename that has no key, so
+  // use this for lookups.
+  static std::optional<FilenameKey> Find(const std::string& filename);
+
+  // IDs are assigned in the order that filenames are first seen, so they
+  // aren't consistent between processes.
+  uint32_t GetId() const;
+  const std::string& GetNormalizedName() const;
+
+  bool operator==(const FilenameKey& rhs) const;
+  bool operator!=(const FilenameKey& rhs) const;
+
+  // Orders keys by ID, not by name.
+  bool operator<(const FilenameKey& rhs) const;
+
+  struct Entry {
+    std::string normalizedName;
+    uint32_t id;
+  };
+
+private:
+  explicit FilenameKey(const Entry* entry);
+
+  const Entry* entry_;
+};
+
+// Looks up a filename in a container keyed by FilenameKey, without creating a
+// key for the filename.
+template<typename Container>
+auto FindFilename(Container& container, const std::string& filename)
+    -> decltype(container.end()) {
+  auto key = FilenameKey::Find(filename);
+  if (!key.has_value()) {
+    return container.end();
+  }
+
+  return container.find(key.value());
+}
+}
+
+namespace std {
+template<>
+struct hash<loot::FilenameKey> {
+  size_t operator()(const loot::FilenameKey& key) const {
+    // IDs are unique, so they're already a perfect hash.
+    return key.GetId();
+  }
+};
+}
+
+#endif
@@ -0,0 +1,107 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "api/helpers/mapped_file.h"
+
+#include <cerrno>
+#include <system_error>
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace loot {
+#ifndef _WIN32
+MappedFile::MappedFile(const std::filesystem::path& path) :
+    data_(nullptr),
+    size_(0) {
+  const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    throw std::system_error(errno, std::generic_category());
+  }
+
+  struct stat fileStatus;
+  if (fstat(fd, &fileStatus) != 0) {
+    const auto error = errno;
+    close(fd);
+    throw std::system_error(error, std::generic_category());
+  }
+
+  size_ = static_cast<size_t>(fileStatus.st_size);
+  if (size_ == 0) {
+    close(fd);
+    return;
+  }
+
+  // The mapping stays valid after the file descriptor is closed.
+  void* mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  const auto error = errno;
+  close(fd);
+
+  if (mapping == MAP_FAILED) {
+    throw std::system_error(error, std::generic_category());
+  }
+
+  data_ = static_cast<const char*>(mapping);
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+}
+#else
+MappedFile::MappedFile(const std::filesystem::path& path) :
+    data_(nullptr),
+    size_(0) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in.is_open()) {
+    throw std::system_error(
+        std::make_error_code(std::errc::no_such_file_or_directory),
+        "Failed to open file");
+  }
+
+  buffer_.assign(std::istreambuf_iterator<char>(in),
+                 std::istreambuf_iterator<char>());
+  if (in.bad()) {
+    throw std::system_error(std::make_error_code(std::errc::io_error),
+                            "Failed to read file");
+  }
+
+  data_ = buffer_.data();
+  size_ = buffer_.size();
+}
+
+MappedFile::~MappedFile() {}
+#endif
+
+const char* MappedFile::Data() const { return data_; }
+
+size_t MappedFile::Size() const { return size_; }
+}
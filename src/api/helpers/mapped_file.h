@@ -0,0 +1,59 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_API_HELPERS_MAPPED_FILE
+#define LOOT_API_HELPERS_MAPPED_FILE
+
+#include <cstddef>
+#include <filesystem>
+#include <vector>
+
+namespace loot {
+// A read-only view of a file's content. On Linux the file is memory-mapped,
+// so its pages are only read when they're accessed. On Windows a mapped file
+// can't be replaced until it's unmapped, which would stop a stale file from
+// being rewritten while its content is still in use, so the file is read into
+// memory instead.
+class MappedFile {
+public:
+  // Throws a std::system_error if the file can't be opened or read.
+  explicit MappedFile(const std::filesystem::path& path);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const char* Data() const;
+  size_t Size() const;
+
+private:
+  const char* data_;
+  size_t size_;
+#ifdef _WIN32
+  std::vector<char> buffer_;
+#endif
+};
+}
+
+#endif
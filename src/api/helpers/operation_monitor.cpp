@@ -0,0 +1,82 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "api/helpers/operation_monitor.h"
+
+#include "loot/exception/operation_cancelled_error.h"
+
+namespace loot {
+OperationMonitor::OperationMonitor() {}
+
+OperationMonitor::OperationMonitor(
+    ProgressCallback progressCallback,
+    std::shared_ptr<const CancellationToken> cancellationToken) :
+    progressCallback_(progressCallback),
+    cancellationToken_(cancellationToken) {}
+
+bool OperationMonitor::IsCancelled() const {
+  return cancellationToken_ && cancellationToken_->IsCancelled();
+}
+
+void OperationMonitor::ThrowIfCancelled() const {
+  if (IsCancelled()) {
+    throw OperationCancelledError();
+  }
+}
+
+void OperationMonitor::StartPhase(OperationPhase phase) {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  progress_.phase = phase;
+  Report();
+}
+
+void OperationMonitor::StartLoadingPlugins(size_t pluginCount,
+                                           uintmax_t byteCount) {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  progress_.phase = OperationPhase::load_plugins;
+  progress_.plugins_loaded = 0;
+  progress_.plugins_to_load = pluginCount;
+  progress_.bytes_loaded = 0;
+  progress_.bytes_to_load = byteCount;
+  Report();
+}
+
+void OperationMonitor::PluginLoaded(uintmax_t byteCount) {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  progress_.plugins_loaded += 1;
+  progress_.bytes_loaded += byteCount;
+  Report();
+}
+
+void OperationMonitor::Report() {
+  // The mutex is held while the callback runs, so calls are never
+  // concurrent and always see progress in order.
+  if (progressCallback_) {
+    progressCallback_(progress_);
+  }
+}
+}
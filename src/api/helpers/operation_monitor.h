@@ -0,0 +1,67 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_API_HELPERS_OPERATION_MONITOR
+#define LOOT_API_HELPERS_OPERATION_MONITOR
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "loot/cancellation_token.h"
+#include "loot/struct/operation_progress.h"
+
+namespace loot {
+// Reports the progress of an operation and checks if it has been cancelled.
+// Both the progress callback and the cancellation token are optional, so a
+// default-constructed monitor does nothing and is never cancelled.
+class OperationMonitor {
+public:
+  OperationMonitor();
+  explicit OperationMonitor(
+      ProgressCallback progressCallback,
+      std::shared_ptr<const CancellationToken> cancellationToken);
+
+  bool IsCancelled() const;
+  // Throws OperationCancelledError if the operation has been cancelled.
+  void ThrowIfCancelled() const;
+
+  void StartPhase(OperationPhase phase);
+  void StartLoadingPlugins(size_t pluginCount, uintmax_t byteCount);
+
+  // Can be called from multiple threads at once.
+  void PluginLoaded(uintmax_t byteCount);
+
+private:
+  void Report();
+
+  ProgressCallback progressCallback_;
+  std::shared_ptr<const CancellationToken> cancellationToken_;
+  OperationProgress progress_;
+
+  std::mutex mutex_;
+};
+}
+
+#endif
@@ -23,10 +23,19 @@
     */
 #include "api/helpers/text.h"
 
-#include <regex>
+#include <algorithm>
 
 #include <boost/algorithm/string.hpp>
 
+// SSE2 is part of the x86-64 baseline, so unlike the CRC code's instructions
+// it doesn't need to be detected at runtime. 32-bit builds only use it if the
+// compiler has been told it's available.
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LOOT_TEXT_SSE2
+#include <emmintrin.h>
+#endif
+
 #ifdef _WIN32
 #include "windows.h"
 #else
@@ -35,41 +44,203 @@
 using icu::UnicodeString;
 #endif
 
-using std::regex;
-
 namespace loot {
-/* The string below matches timestamps that use forwardslashes for date
-   separators. However, Pseudosem v1.0.1 will only compare the first
-   two digits as it does not recognise forwardslashes as separators. */
-const std::string dateRegex =
-    R"((\d{1,2}/\d{1,2}/\d{1,4} \d{1,2}:\d{1,2}:\d{1,2}))";
-
-/* The string below matches the range of version strings supported by
-   Pseudosem v1.0.1, excluding space separators, as they make version
-   extraction from inside sentences very tricky and have not been
-   seen "in the wild". */
-const std::string pseudosemVersionRegex =
-    R"((\d+(?:\.\d+)+(?:[-._:]?[A-Za-z0-9]+)*))"
-    // The string below prevents version numbers followed by a comma from
-    // matching.
-    R"((?!,))";
-
-/* There are a few different version formats that can appear in strings
-   together, and in order to extract the correct one, they must be searched
-   for in order of priority. */
-const std::vector<regex> versionRegexes({
-    regex(dateRegex, regex::ECMAScript | regex::icase),
-    regex(R"(version:?\s)" + pseudosemVersionRegex,
-          regex::ECMAScript | regex::icase),
-    regex(R"((?:^|v|\s))" + pseudosemVersionRegex,
-          regex::ECMAScript | regex::icase),
-    regex(
-        /* The string below matches a number containing one or more digits
-           found at the start of the search string or preceded by 'v' or
-           'version:. */
-        R"((?:^|v|version:\s*)(\d+))",
-        regex::ECMAScript | regex::icase),
-});
+inline bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+inline bool IsAsciiAlphanumeric(char c) {
+  return IsDigit(c) || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+}
+
+inline bool IsAsciiSpace(char c) {
+  return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+inline bool IsVersionSeparator(char c) {
+  return c == '-' || c == '.' || c == '_' || c == ':';
+}
+
+// Counts the digits starting at pos, up to the given limit.
+size_t CountDigits(const std::string& text, size_t pos, size_t limit) {
+  size_t count = 0;
+  while (count < limit && pos + count < text.size() &&
+         IsDigit(text[pos + count])) {
+    ++count;
+  }
+  return count;
+}
+
+/* Matches timestamps that use forwardslashes for date separators, e.g.
+   "10/09/2016 13:15:18". However, Pseudosem v1.0.1 will only compare the first
+   two digits as it does not recognise forwardslashes as separators. Returns
+   the length of the timestamp starting at pos, or 0 if there isn't one. */
+size_t MatchTimestamp(const std::string& text, size_t pos) {
+  struct Field {
+    size_t maxDigits;
+    char terminator;
+  };
+  static constexpr Field fields[] = {
+      {2, '/'}, {2, '/'}, {4, ' '}, {2, ':'}, {2, ':'}};
+  static constexpr size_t secondsMaxDigits = 2;
+
+  size_t end = pos;
+  for (const auto& field : fields) {
+    auto digits = CountDigits(text, end, field.maxDigits + 1);
+    if (digits == 0 || digits > field.maxDigits ||
+        end + digits >= text.size() || text[end + digits] != field.terminator) {
+      return 0;
+    }
+    end += digits + 1;
+  }
+
+  auto digits = CountDigits(text, end, secondsMaxDigits);
+  if (digits == 0) {
+    return 0;
+  }
+
+  return end + digits - pos;
+}
+
+/* Matches the range of version strings supported by Pseudosem v1.0.1,
+   excluding space separators, as they make version extraction from inside
+   sentences very tricky and have not been seen "in the wild". That's two or
+   more period-separated numbers, optionally followed by alphanumeric parts
+   that may each be preceded by one of "-._:". Returns the length of the
+   version starting at pos, or 0 if there isn't one.
+
+   Version numbers followed by a comma are not matched, but like the regex
+   that this replaces, a shorter version that isn't followed by a comma is
+   matched instead if there is one, e.g. "1.2" in "1.23,". */
+size_t MatchPseudosemVersion(const std::string& text, size_t pos) {
+  auto end = pos + CountDigits(text, pos, text.size());
+  if (end == pos || end + 1 >= text.size() || text[end] != '.' ||
+      !IsDigit(text[end + 1])) {
+    return 0;
+  }
+
+  // The version can end after any of the alphanumeric characters that follow
+  // the first period, up until a character that can't be part of the version
+  // or two adjacent separators. Only the last possible end can be followed
+  // by a comma, so also keep the end before it.
+  size_t lastEnd = 0;
+  size_t previousEnd = 0;
+  bool afterSeparator = false;
+  for (auto i = end + 1; i < text.size(); ++i) {
+    if (IsAsciiAlphanumeric(text[i])) {
+      previousEnd = lastEnd;
+      lastEnd = i + 1;
+      afterSeparator = false;
+    } else if (IsVersionSeparator(text[i]) && !afterSeparator) {
+      afterSeparator = true;
+    } else {
+      break;
+    }
+  }
+
+  if (lastEnd < text.size() && text[lastEnd] == ',') {
+    lastEnd = previousEnd;
+  }
+
+  return lastEnd == 0 ? 0 : lastEnd - pos;
+}
+
+static constexpr char VERSION_LABEL[] = "version";
+static constexpr size_t VERSION_LABEL_LENGTH = sizeof(VERSION_LABEL) - 1;
+
+// Checks for a case-insensitive "version" starting at pos.
+bool IsVersionLabel(const std::string& text, size_t pos) {
+  if (text.size() - pos < VERSION_LABEL_LENGTH) {
+    return false;
+  }
+
+  for (size_t i = 0; i < VERSION_LABEL_LENGTH; ++i) {
+    // All the label's characters are letters, so setting the case bit
+    // lowercases exactly the characters that could match.
+    if ((text[pos + i] | 0x20) != VERSION_LABEL[i]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+inline bool IsV(char c) { return c == 'v' || c == 'V'; }
+
+// Matches "version", an optional colon and a whitespace character followed
+// by a Pseudosem version, returning the version.
+std::optional<std::string> MatchLabelledVersion(const std::string& text,
+                                                size_t pos) {
+  if (!IsVersionLabel(text, pos)) {
+    return std::nullopt;
+  }
+
+  auto versionPos = pos + VERSION_LABEL_LENGTH;
+  if (versionPos < text.size() && text[versionPos] == ':') {
+    ++versionPos;
+  }
+
+  if (versionPos >= text.size() || !IsAsciiSpace(text[versionPos])) {
+    return std::nullopt;
+  }
+  ++versionPos;
+
+  auto length = MatchPseudosemVersion(text, versionPos);
+  if (length == 0) {
+    return std::nullopt;
+  }
+
+  return text.substr(versionPos, length);
+}
+
+// Matches a Pseudosem version at the start of the text or preceded by "v" or
+// a whitespace character, returning the version.
+std::optional<std::string> MatchDelimitedVersion(const std::string& text,
+                                                 size_t pos) {
+  if (pos == 0) {
+    auto length = MatchPseudosemVersion(text, pos);
+    if (length > 0) {
+      return text.substr(pos, length);
+    }
+  }
+
+  if (!IsV(text[pos]) && !IsAsciiSpace(text[pos])) {
+    return std::nullopt;
+  }
+
+  auto length = MatchPseudosemVersion(text, pos + 1);
+  if (length == 0) {
+    return std::nullopt;
+  }
+
+  return text.substr(pos + 1, length);
+}
+
+// Matches a number at the start of the text or preceded by "v" or
+// "version:" and optional whitespace, returning the number.
+std::optional<std::string> MatchNumber(const std::string& text, size_t pos) {
+  auto numberPos = pos;
+  if (pos == 0 && IsDigit(text[pos])) {
+    numberPos = pos;
+  } else if (IsV(text[pos]) && pos + 1 < text.size() &&
+             IsDigit(text[pos + 1])) {
+    numberPos = pos + 1;
+  } else if (IsVersionLabel(text, pos) &&
+             pos + VERSION_LABEL_LENGTH < text.size() &&
+             text[pos + VERSION_LABEL_LENGTH] == ':') {
+    numberPos = pos + VERSION_LABEL_LENGTH + 1;
+    while (numberPos < text.size() && IsAsciiSpace(text[numberPos])) {
+      ++numberPos;
+    }
+  } else {
+    return std::nullopt;
+  }
+
+  auto digits = CountDigits(text, numberPos, text.size());
+  if (digits == 0) {
+    return std::nullopt;
+  }
+
+  return text.substr(numberPos, digits);
+}
 
 std::set<Tag> ExtractBashTags(const std::string& description) {
   std::set<Tag> tags;
@@ -99,22 +270,42 @@ std::set<Tag> ExtractBashTags(const std::string& description) {
 }
 
 std::optional<std::string> ExtractVersion(const std::string& text) {
-  std::smatch what;
-  for (const auto& versionRegex : versionRegexes) {
-    if (std::regex_search(text, what, versionRegex)) {
-      for (auto it = next(begin(what)); it != end(what); ++it) {
-        if (it->str().empty())
-          continue;
-
-        // Use the first non-empty sub-match.
-        std::string version = *it;
-        boost::trim(version);
-        return version;
-      }
+  // There are a few different version formats that can appear in strings
+  // together, and in order to extract the correct one, they must be searched
+  // for in order of priority. Rather than scanning the text once per format,
+  // check every format at each position and keep the first match of each,
+  // returning early if the highest-priority format is found.
+  std::optional<std::string> labelledVersion;
+  std::optional<std::string> delimitedVersion;
+  std::optional<std::string> number;
+  for (size_t pos = 0; pos < text.size(); ++pos) {
+    auto timestampLength = MatchTimestamp(text, pos);
+    if (timestampLength > 0) {
+      return text.substr(pos, timestampLength);
+    }
+
+    if (labelledVersion) {
+      continue;
+    }
+    labelledVersion = MatchLabelledVersion(text, pos);
+
+    if (delimitedVersion) {
+      continue;
+    }
+    delimitedVersion = MatchDelimitedVersion(text, pos);
+
+    if (!number) {
+      number = MatchNumber(text, pos);
     }
   }
 
-  return std::nullopt;
+  if (labelledVersion) {
+    return labelledVersion;
+  }
+  if (delimitedVersion) {
+    return delimitedVersion;
+  }
+  return number;
 }
 
 #ifdef _WIN32
@@ -135,7 +326,117 @@ std::string FromWinWide(const std::wstring& wstr) {
 }
 #endif
 
+// Nearly all plugin filenames are ASCII, and ASCII characters have the same
+// case mapping on Windows and in ICU, so they can be compared and normalised
+// without converting to UTF-16. Windows uppercases filenames and ICU folds them
+// to lowercase, and which is used affects how letters sort relative to the
+// punctuation between the uppercase and lowercase ranges.
+#ifdef _WIN32
+static constexpr char ASCII_FOLD_FIRST = 'a';
+#else
+static constexpr char ASCII_FOLD_FIRST = 'A';
+#endif
+static constexpr char ASCII_FOLD_LAST = ASCII_FOLD_FIRST + 25;
+
+inline char FoldAsciiCase(char c) {
+  return c >= ASCII_FOLD_FIRST && c <= ASCII_FOLD_LAST ? c ^ 0x20 : c;
+}
+
+#ifdef LOOT_TEXT_SSE2
+inline __m128i FoldAsciiCase(__m128i chars) {
+  // Bytes are compared as signed values, so non-ASCII bytes are negative and
+  // never in the range.
+  const __m128i isInRange = _mm_and_si128(
+      _mm_cmpgt_epi8(chars, _mm_set1_epi8(ASCII_FOLD_FIRST - 1)),
+      _mm_cmplt_epi8(chars, _mm_set1_epi8(ASCII_FOLD_LAST + 1)));
+
+  return _mm_xor_si128(chars, _mm_and_si128(isInRange, _mm_set1_epi8(0x20)));
+}
+
+inline __m128i LoadChars(const char* chars) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(chars));
+}
+#endif
+
+bool IsAscii(const std::string& text) {
+  const char* chars = text.data();
+  const size_t length = text.length();
+  size_t i = 0;
+
+#ifdef LOOT_TEXT_SSE2
+  __m128i highBits = _mm_setzero_si128();
+  for (; i + 16 <= length; i += 16) {
+    highBits = _mm_or_si128(highBits, LoadChars(chars + i));
+  }
+
+  if (_mm_movemask_epi8(highBits) != 0) {
+    return false;
+  }
+#endif
+
+  unsigned char highBit = 0;
+  for (; i < length; ++i) {
+    highBit |= static_cast<unsigned char>(chars[i]);
+  }
+
+  return (highBit & 0x80) == 0;
+}
+
+int CompareAsciiFilenames(const std::string& lhs, const std::string& rhs) {
+  const size_t length = std::min(lhs.length(), rhs.length());
+  size_t i = 0;
+
+#ifdef LOOT_TEXT_SSE2
+  // Skip over the blocks that are equal once folded, and leave the first
+  // block that differs to be compared bytewise.
+  for (; i + 16 <= length; i += 16) {
+    const __m128i lhsBlock = FoldAsciiCase(LoadChars(lhs.data() + i));
+    const __m128i rhsBlock = FoldAsciiCase(LoadChars(rhs.data() + i));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(lhsBlock, rhsBlock)) != 0xFFFF) {
+      break;
+    }
+  }
+#endif
+
+  for (; i < length; ++i) {
+    const char lhsChar = FoldAsciiCase(lhs[i]);
+    const char rhsChar = FoldAsciiCase(rhs[i]);
+    if (lhsChar != rhsChar) {
+      return lhsChar < rhsChar ? -1 : 1;
+    }
+  }
+
+  if (lhs.length() == rhs.length()) {
+    return 0;
+  }
+
+  return lhs.length() < rhs.length() ? -1 : 1;
+}
+
+std::string NormalizeAsciiFilename(const std::string& filename) {
+  std::string normalizedFilename(filename.length(), '\0');
+  size_t i = 0;
+
+#ifdef LOOT_TEXT_SSE2
+  for (; i + 16 <= filename.length(); i += 16) {
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(&normalizedFilename[i]),
+        FoldAsciiCase(LoadChars(filename.data() + i)));
+  }
+#endif
+
+  for (; i < filename.length(); ++i) {
+    normalizedFilename[i] = FoldAsciiCase(filename[i]);
+  }
+
+  return normalizedFilename;
+}
+
 int CompareFilenames(const std::string& lhs, const std::string& rhs) {
+  if (IsAscii(lhs) && IsAscii(rhs)) {
+    return CompareAsciiFilenames(lhs, rhs);
+  }
+
 #ifdef _WIN32
   // On Windows, use CompareStringOrdinal as that will perform case conversion
   // using the operating system uppercase table information, which (I think)
@@ -161,6 +462,10 @@ int CompareFilenames(const std::string& lhs, const std::string& rhs) {
 }
 
 std::string NormalizeFilename(const std::string& filename) {
+  if (IsAscii(filename)) {
+    return NormalizeAsciiFilename(filename);
+  }
+
 #ifdef _WIN32
   auto wideString = ToWinWide(filename);
   CharUpperBuffW(&wideString[0], wideString.length());
@@ -173,4 +478,11 @@ std::string NormalizeFilename(const std::string& filename) {
   return normalizedFilename;
 #endif
 }
+
+std::string TrimGhostExtension(const std::string& pluginName) {
+  if (boost::iends_with(pluginName, ".ghost"))
+    return pluginName.substr(0, pluginName.length() - 6);
+
+  return pluginName;
+}
 }
@@ -49,6 +49,10 @@ int CompareFilenames(const std::string& lhs, const std::string& rhs);
 // that the normalized filenames distinguish characters in a similar way to the
 // Windows filesystem.
 std::string NormalizeFilename(const std::string& filename);
+
+// Removes a trailing .ghost extension from the given plugin filename, if it
+// has one.
+std::string TrimGhostExtension(const std::string& pluginName);
 }
 
 #endif
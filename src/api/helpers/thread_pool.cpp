@@ -0,0 +1,168 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "api/helpers/thread_pool.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace loot {
+ThreadPool::ThreadPool(size_t threadCount) :
+    queuedTasks_(0),
+    unfinishedTasks_(0),
+    stopping_(false) {
+  threadCount = std::max(threadCount, (size_t)1);
+
+  for (size_t i = 0; i < threadCount; ++i) {
+    queues_.push_back(std::make_unique<TaskQueue>());
+  }
+
+  for (size_t i = 0; i < threadCount; ++i) {
+    threads_.push_back(std::thread([this, i]() { RunWorker(i); }));
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  workAvailable_.notify_all();
+
+  for (auto& thread : threads_) {
+    if (thread.joinable())
+      thread.join();
+  }
+}
+
+size_t ThreadPool::ThreadCount() const { return threads_.size(); }
+
+void ThreadPool::Run(std::vector<std::function<void()>> tasks) {
+  if (tasks.empty()) {
+    return;
+  }
+
+  if (IsPoolThread()) {
+    throw std::logic_error(
+        "ThreadPool::Run() cannot be called from a task that the pool is "
+        "running");
+  }
+
+  std::lock_guard<std::mutex> runLock(runMutex_);
+
+  const auto taskCount = tasks.size();
+  {
+    // Count the tasks before queueing them, and queue them while holding the
+    // lock, so that a task can't be taken or finish before it is counted.
+    std::lock_guard<std::mutex> lock(mutex_);
+    unfinishedTasks_ = taskCount;
+    queuedTasks_ += taskCount;
+    exception_ = nullptr;
+
+    // Deal the tasks out in turn, so that each thread starts with one of the
+    // first tasks given.
+    for (size_t i = 0; i < taskCount; ++i) {
+      auto& queue = *queues_[i % queues_.size()];
+      std::lock_guard<std::mutex> queueLock(queue.mutex);
+      queue.tasks.push_back(std::move(tasks[i]));
+    }
+  }
+
+  workAvailable_.notify_all();
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  workFinished_.wait(lock, [&]() { return unfinishedTasks_ == 0; });
+
+  if (exception_) {
+    auto exception = exception_;
+    exception_ = nullptr;
+    std::rethrow_exception(exception);
+  }
+}
+
+bool ThreadPool::IsPoolThread() const {
+  const auto threadId = std::this_thread::get_id();
+  return std::any_of(threads_.begin(), threads_.end(), [&](const auto& thread) {
+    return thread.get_id() == threadId;
+  });
+}
+
+bool ThreadPool::TakeTask(size_t queueIndex, std::function<void()>& task) {
+  // Take from this thread's own queue first, then steal from the other
+  // queues, starting with the next thread's queue. Queues are ordered
+  // longest task first, so always take from the front, including when
+  // stealing, to keep the longest remaining tasks running earliest.
+  for (size_t i = 0; i < queues_.size(); ++i) {
+    auto& queue = *queues_[(queueIndex + i) % queues_.size()];
+    {
+      std::lock_guard<std::mutex> queueLock(queue.mutex);
+      if (queue.tasks.empty()) {
+        continue;
+      }
+
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+    }
+
+    // Run() holds mutex_ while it locks the queues, so the queue lock must be
+    // released first. The count is only decremented after a task has been
+    // taken, so it never drops below the number of tasks in the queues.
+    std::lock_guard<std::mutex> lock(mutex_);
+    queuedTasks_ -= 1;
+    return true;
+  }
+
+  return false;
+}
+
+void ThreadPool::RunWorker(size_t queueIndex) {
+  while (true) {
+    std::function<void()> task;
+    if (TakeTask(queueIndex, task)) {
+      try {
+        task();
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!exception_) {
+          exception_ = std::current_exception();
+        }
+      }
+
+      std::lock_guard<std::mutex> lock(mutex_);
+      unfinishedTasks_ -= 1;
+      if (unfinishedTasks_ == 0) {
+        workFinished_.notify_all();
+      }
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    workAvailable_.wait(lock,
+                        [&]() { return stopping_ || queuedTasks_ > 0; });
+    if (stopping_ && queuedTasks_ == 0) {
+      return;
+    }
+  }
+}
+}
@@ -0,0 +1,89 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_API_HELPERS_THREAD_POOL
+#define LOOT_API_HELPERS_THREAD_POOL
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace loot {
+// A fixed-size pool of threads that persist between calls to Run(). Each
+// thread has its own queue of tasks, and a thread that empties its queue
+// steals the next task from the front of the other threads' queues, so that a
+// few long-running tasks don't leave the other threads idle.
+class ThreadPool {
+public:
+  explicit ThreadPool(size_t threadCount);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  size_t ThreadCount() const;
+
+  // Runs the given tasks and blocks until they have all finished. Tasks are
+  // started roughly in the order given, so callers should put the longest
+  // tasks first. If any tasks throw, the first exception caught is rethrown
+  // once all tasks have finished. Calls are serialised, so a task must not
+  // call Run() on the pool that is running it: doing so throws a
+  // std::logic_error instead of deadlocking.
+  void Run(std::vector<std::function<void()>> tasks);
+
+private:
+  struct TaskQueue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  bool IsPoolThread() const;
+  bool TakeTask(size_t queueIndex, std::function<void()>& task);
+  void RunWorker(size_t queueIndex);
+
+  std::vector<std::unique_ptr<TaskQueue>> queues_;
+  std::vector<std::thread> threads_;
+
+  // Serialises calls to Run().
+  std::mutex runMutex_;
+
+  // Guards the fields below, which are used to wake idle threads and to
+  // signal when all tasks are finished. Tasks are pushed onto the queues
+  // while it is held, so the queued count never falls behind the queues.
+  std::mutex mutex_;
+  std::condition_variable workAvailable_;
+  std::condition_variable workFinished_;
+  size_t queuedTasks_;
+  size_t unfinishedTasks_;
+  std::exception_ptr exception_;
+  bool stopping_;
+};
+}
+
+#endif
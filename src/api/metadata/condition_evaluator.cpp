@@ -208,7 +208,8 @@ void ConditionEvaluator::RefreshState(std::shared_ptr<GameCache> gameCache) {
   std::vector<std::string> pluginNames;
   std::vector<std::string> pluginVersionStrings;
   std::vector<uint32_t> crcs;
-  for (auto plugin : gameCache->GetPlugins()) {
+  auto snapshot = gameCache->GetPluginsSnapshot();
+  for (const auto& plugin : snapshot->plugins) {
     pluginNames.push_back(plugin->GetName());
     pluginVersionStrings.push_back(plugin->GetVersion().value_or(""));
     crcs.push_back(plugin->GetCRC().value_or(0));
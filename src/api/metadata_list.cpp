@@ -24,9 +24,13 @@
 
 #include "api/metadata_list.h"
 
+#include <algorithm>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <iterator>
 
+#include "api/compiled_metadata_list.h"
 #include "api/game/game.h"
 #include "api/helpers/logging.h"
 #include "api/helpers/text.h"
@@ -36,6 +40,65 @@
 #include "loot/exception/file_access_error.h"
 
 namespace loot {
+// Gets the literal characters that a regex starts with, stopping early so
+// that the result is always a prefix of any name that the regex matches.
+std::string GetLiteralPrefix(const std::string& regex) {
+  // Alternatives can start with anything.
+  if (regex.find('|') != std::string::npos) {
+    return "";
+  }
+
+  static constexpr char SPECIAL_CHARACTERS[] = "^$\\.*+?()[]{}|";
+  auto end = std::find_if(regex.begin(), regex.end(), [](char c) {
+    return static_cast<unsigned char>(c) > 0x7F ||
+           std::strchr(SPECIAL_CHARACTERS, c) != nullptr;
+  });
+
+  // The last literal character is optional or repeated if it's followed by a
+  // quantifier.
+  if (end != regex.begin() && end != regex.end() &&
+      (*end == '*' || *end == '+' || *end == '?' || *end == '{')) {
+    --end;
+  }
+
+  return std::string(regex.begin(), end);
+}
+
+char ToLowerAscii(char c) {
+  return c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c;
+}
+
+bool StartsWithIgnoringAsciiCase(const std::string& text,
+                                 const std::string& prefix) {
+  return text.size() >= prefix.size() &&
+         std::equal(prefix.begin(),
+                    prefix.end(),
+                    text.begin(),
+                    [](char lhs, char rhs) {
+                      return ToLowerAscii(lhs) == ToLowerAscii(rhs);
+                    });
+}
+
+RegexPluginMetadata::RegexPluginMetadata(const PluginMetadata& metadata) :
+    metadata_(metadata),
+    regex_(std::make_shared<std::regex>(
+        metadata.GetName(),
+        std::regex::ECMAScript | std::regex::icase)),
+    literalPrefix_(GetLiteralPrefix(metadata.GetName())) {}
+
+const PluginMetadata& RegexPluginMetadata::GetMetadata() const {
+  return metadata_;
+}
+
+void RegexPluginMetadata::SetMetadata(const PluginMetadata& metadata) {
+  metadata_ = metadata;
+}
+
+bool RegexPluginMetadata::NameMatches(const std::string& pluginName) const {
+  return StartsWithIgnoringAsciiCase(pluginName, literalPrefix_) &&
+         std::regex_match(pluginName, *regex_);
+}
+
 void MetadataList::Load(const std::filesystem::path& filepath) {
   Clear();
 
@@ -44,12 +107,60 @@ void MetadataList::Load(const std::filesystem::path& filepath) {
     logger->debug("Loading file: {}", filepath.u8string());
   }
 
+  Parse(ReadFile(filepath), filepath);
+
+  if (logger) {
+    logger->debug("File loaded successfully.");
+  }
+}
+
+void MetadataList::Load(const std::filesystem::path& filepath,
+                        const std::filesystem::path& compiledPath) {
+  Clear();
+
+  auto logger = getLogger();
+  if (logger) {
+    logger->debug("Loading file: {}", filepath.u8string());
+  }
+
+  const auto content = ReadFile(filepath);
+  const auto sourceKey = GetMetadataSourceKey(content);
+
+  compiledList_ = CompiledMetadataList::Open(compiledPath, sourceKey);
+  if (compiledList_) {
+    if (logger) {
+      logger->debug("Using the compiled metadata list at: {}",
+                    compiledPath.u8string());
+    }
+
+    bashTags_ = compiledList_->GetBashTags();
+    groups_ = compiledList_->GetGroups();
+    messages_ = compiledList_->GetMessages();
+    for (const auto& plugin : compiledList_->GetRegexPlugins()) {
+      regexPlugins_.push_back(RegexPluginMetadata(plugin));
+    }
+  } else {
+    Parse(content, filepath);
+    CompiledMetadataList::Write(compiledPath, sourceKey, *this);
+  }
+
+  if (logger) {
+    logger->debug("File loaded successfully.");
+  }
+}
+
+std::string MetadataList::ReadFile(const std::filesystem::path& filepath) {
   std::ifstream in(filepath);
   if (!in.good())
     throw FileAccessError("Cannot open " + filepath.u8string());
 
-  YAML::Node metadataList = YAML::Load(in);
-  in.close();
+  return std::string(std::istreambuf_iterator<char>(in),
+                     std::istreambuf_iterator<char>());
+}
+
+void MetadataList::Parse(const std::string& content,
+                         const std::filesystem::path& filepath) {
+  YAML::Node metadataList = YAML::Load(content);
 
   if (!metadataList.IsMap())
     throw FileAccessError("The root of the metadata file " + filepath.u8string() +
@@ -59,8 +170,8 @@ void MetadataList::Load(const std::filesystem::path& filepath) {
     for (const auto& node : metadataList["plugins"]) {
       PluginMetadata plugin(node.as<PluginMetadata>());
       if (plugin.IsRegexPlugin())
-        regexPlugins_.push_back(plugin);
-      else if (!plugins_.insert(plugin).second)
+        regexPlugins_.push_back(RegexPluginMetadata(plugin));
+      else if (!plugins_.emplace(FilenameKey(plugin.GetName()), plugin).second)
         throw FileAccessError("More than one entry exists for \"" +
                               plugin.GetName() + "\"");
     }
@@ -75,10 +186,6 @@ void MetadataList::Load(const std::filesystem::path& filepath) {
     groups_ = metadataList["groups"].as<std::unordered_set<Group>>();
 
   groups_.insert(Group());
-
-  if (logger) {
-    logger->debug("File loaded successfully.");
-  }
 }
 
 void MetadataList::Save(const std::filesystem::path& filepath) const {
@@ -122,13 +229,22 @@ void MetadataList::Clear() {
   plugins_.clear();
   regexPlugins_.clear();
   messages_.clear();
+  compiledList_.reset();
 }
 
 std::vector<PluginMetadata> MetadataList::Plugins() const {
   std::vector<PluginMetadata> plugins;
-  plugins.reserve(plugins_.size() + regexPlugins_.size());
-  plugins.insert(plugins.end(), plugins_.begin(), plugins_.end());
-  plugins.insert(plugins.end(), regexPlugins_.begin(), regexPlugins_.end());
+  if (compiledList_) {
+    plugins = compiledList_->GetPlugins();
+  }
+
+  plugins.reserve(plugins.size() + plugins_.size() + regexPlugins_.size());
+  for (const auto& plugin : plugins_) {
+    plugins.push_back(plugin.second);
+  }
+  for (const auto& plugin : regexPlugins_) {
+    plugins.push_back(plugin.GetMetadata());
+  }
 
   return plugins;
 }
@@ -147,19 +263,33 @@ void MetadataList::SetGroups(const std::unordered_set<Group>& groups) {
 // Merges multiple matching regex entries if any are found.
 std::optional<PluginMetadata> MetadataList::FindPlugin(
     const std::string& pluginName) const {
-  PluginMetadata match(pluginName);
-
-  auto it = plugins_.find(match);
-
-  if (it != plugins_.end())
-    match = *it;
-
-  // Now we want to also match possibly multiple regex entries.
-  auto regIt = find(regexPlugins_.begin(), regexPlugins_.end(), match);
-  while (regIt != regexPlugins_.end()) {
-    match.MergeMetadata(*regIt);
+  // Like the PluginMetadata constructor, ignore any .ghost extension.
+  const auto trimmedName = TrimGhostExtension(pluginName);
+  PluginMetadata match(trimmedName);
+  const bool isRegexName = match.IsRegexPlugin();
+
+  if (compiledList_) {
+    auto compiledMatch = compiledList_->FindPlugin(trimmedName);
+    if (compiledMatch.has_value())
+      match = compiledMatch.value();
+  } else {
+    auto it = FindFilename(plugins_, trimmedName);
+
+    if (it != plugins_.end())
+      match = it->second;
+  }
 
-    regIt = find(++regIt, regexPlugins_.end(), match);
+  // Now we want to also match possibly multiple regex entries. Like
+  // PluginMetadata::operator==, compare a regex name with them by name.
+  for (const auto& regexPlugin : regexPlugins_) {
+    const auto& regexMetadata = regexPlugin.GetMetadata();
+    const bool matches =
+        isRegexName
+            ? CompareFilenames(regexMetadata.GetName(), trimmedName) == 0
+            : regexPlugin.NameMatches(trimmedName);
+    if (matches) {
+      match.MergeMetadata(regexMetadata);
+    }
   }
 
   if (match.HasNameOnly()) {
@@ -170,10 +300,19 @@ std::optional<PluginMetadata> MetadataList::FindPlugin(
 }
 
 void MetadataList::AddPlugin(const PluginMetadata& plugin) {
-  if (plugin.IsRegexPlugin())
-    regexPlugins_.push_back(plugin);
-  else {
-    if (!plugins_.insert(plugin).second)
+  DecodeCompiledPlugins();
+
+  if (plugin.IsRegexPlugin()) {
+    try {
+      regexPlugins_.push_back(RegexPluginMetadata(plugin));
+    } catch (const std::regex_error& e) {
+      throw std::invalid_argument("Cannot add \"" + plugin.GetName() +
+                                  "\" to the metadata list as its name is "
+                                  "not a valid regex: " +
+                                  e.what());
+    }
+  } else {
+    if (!plugins_.emplace(FilenameKey(plugin.GetName()), plugin).second)
       throw std::invalid_argument(
           "Cannot add \"" + plugin.GetName() +
           "\" to the metadata list as another entry already exists.");
@@ -183,7 +322,9 @@ void MetadataList::AddPlugin(const PluginMetadata& plugin) {
 // Doesn't erase matching regex entries, because they might also
 // be required for other plugins.
 void MetadataList::ErasePlugin(const std::string& pluginName) {
-  auto it = plugins_.find(PluginMetadata(pluginName));
+  DecodeCompiledPlugins();
+
+  auto it = FindFilename(plugins_, TrimGhostExtension(pluginName));
 
   if (it != plugins_.end()) {
     plugins_.erase(it);
@@ -197,13 +338,16 @@ void MetadataList::AppendMessage(const Message& message) {
 
 void MetadataList::EvalAllConditions(
     ConditionEvaluator& conditionEvaluator) {
+  DecodeCompiledPlugins();
+
   if (unevaluatedPlugins_.empty())
     unevaluatedPlugins_.swap(plugins_);
   else
     plugins_.clear();
 
   for (const auto& plugin : unevaluatedPlugins_) {
-    plugins_.insert(conditionEvaluator.EvaluateAll(plugin));
+    plugins_.emplace(plugin.first,
+                     conditionEvaluator.EvaluateAll(plugin.second));
   }
 
   if (unevaluatedRegexPlugins_.empty())
@@ -212,7 +356,7 @@ void MetadataList::EvalAllConditions(
     regexPlugins_ = unevaluatedRegexPlugins_;
 
   for (auto& plugin : regexPlugins_) {
-    plugin = conditionEvaluator.EvaluateAll(plugin);
+    plugin.SetMetadata(conditionEvaluator.EvaluateAll(plugin.GetMetadata()));
   }
 
   if (unevaluatedMessages_.empty())
@@ -225,4 +369,16 @@ void MetadataList::EvalAllConditions(
       messages_.push_back(message);
   }
 }
+
+void MetadataList::DecodeCompiledPlugins() {
+  if (!compiledList_) {
+    return;
+  }
+
+  for (const auto& plugin : compiledList_->GetPlugins()) {
+    plugins_.emplace(FilenameKey(plugin.GetName()), plugin);
+  }
+
+  compiledList_.reset();
+}
 }
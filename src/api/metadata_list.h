@@ -26,37 +26,61 @@
 #define LOOT_API_METADATA_LIST
 
 #include <filesystem>
+#include <memory>
 #include <optional>
+#include <regex>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#include "api/helpers/filename_key.h"
 #include "api/helpers/text.h"
 #include "api/metadata/condition_evaluator.h"
 #include "loot/metadata/group.h"
 #include "loot/metadata/plugin_metadata.h"
 
-namespace std {
-  /**
-    * A specialisation of std::hash for loot::PluginMetadata.
-    */
-  template<>
-  struct hash<loot::PluginMetadata> {
-    /**
-      * Calculate a hash value for an object of a class that implements
-      * loot::PluginMetadata.
-      * @return The hash generated from the plugin's normalized filename.
-      */
-    size_t operator()(const loot::PluginMetadata& plugin) const {
-      return hash<string>()(loot::NormalizeFilename(plugin.GetName()));
-    }
-  };
-}
-
 namespace loot {
+class CompiledMetadataList;
+
+// Metadata for plugins with names that match a regex. The regex is compiled
+// once, instead of each time a plugin name is compared with the metadata.
+class RegexPluginMetadata {
+public:
+  // Throws a std::regex_error if the metadata's name is not a valid regex.
+  explicit RegexPluginMetadata(const PluginMetadata& metadata);
+
+  const PluginMetadata& GetMetadata() const;
+
+  // Replaces the metadata while keeping the compiled regex, so the given
+  // metadata must have the same name, e.g. if its conditions were evaluated.
+  void SetMetadata(const PluginMetadata& metadata);
+
+  // Checks if the given plugin name matches the regex. The name must not
+  // itself be a regex: those are compared with the metadata's name instead.
+  bool NameMatches(const std::string& pluginName) const;
+
+private:
+  PluginMetadata metadata_;
+  std::shared_ptr<const std::regex> regex_;
+
+  // Literal text that any matching name must start with, used to rule out
+  // most names without running the regex.
+  std::string literalPrefix_;
+};
+
 class MetadataList {
 public:
+  // Regex entries are compiled as they're loaded, so loading throws if any
+  // of their names are not valid regexes.
   void Load(const std::filesystem::path& filepath);
+
+  // Loads the metadata from the compiled list at compiledPath if it was
+  // compiled from the current content of filepath, otherwise parses filepath
+  // and writes a new compiled list. Plugin entries are only decoded from a
+  // compiled list as they're needed, until the list is modified.
+  void Load(const std::filesystem::path& filepath,
+            const std::filesystem::path& compiledPath);
   void Save(const std::filesystem::path& filepath) const;
   void Clear();
 
@@ -69,6 +93,9 @@ public:
 
   // Merges multiple matching regex entries if any are found.
   std::optional<PluginMetadata> FindPlugin(const std::string& pluginName) const;
+
+  // Throws a std::invalid_argument if the plugin is a regex entry with an
+  // invalid regex as its name, or if an entry already exists for the plugin.
   void AddPlugin(const PluginMetadata& plugin);
 
   // Doesn't erase matching regex entries, because they might also
@@ -83,13 +110,22 @@ public:
 protected:
   std::unordered_set<Group> groups_;
   std::set<std::string> bashTags_;
-  std::unordered_set<PluginMetadata> plugins_;
-  std::vector<PluginMetadata> regexPlugins_;
+  std::unordered_map<FilenameKey, PluginMetadata> plugins_;
+  std::vector<RegexPluginMetadata> regexPlugins_;
   std::vector<Message> messages_;
 
-  std::unordered_set<PluginMetadata> unevaluatedPlugins_;
-  std::vector<PluginMetadata> unevaluatedRegexPlugins_;
+  std::unordered_map<FilenameKey, PluginMetadata> unevaluatedPlugins_;
+  std::vector<RegexPluginMetadata> unevaluatedRegexPlugins_;
   std::vector<Message> unevaluatedMessages_;
+
+  // Holds the non-regex plugin entries instead of plugins_ while set.
+  std::shared_ptr<const CompiledMetadataList> compiledList_;
+
+private:
+  static std::string ReadFile(const std::filesystem::path& filepath);
+  void Parse(const std::string& content,
+             const std::filesystem::path& filepath);
+  void DecodeCompiledPlugins();
 };
 }
 
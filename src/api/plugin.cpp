@@ -41,19 +41,31 @@ namespace loot {
 Plugin::Plugin(const GameType gameType,
                std::shared_ptr<GameCache> gameCache,
                std::filesystem::path pluginPath,
-               const bool headerOnly) :
-    name_(pluginPath.filename().u8string()),
+               const bool headerOnly,
+               const std::optional<PluginFileData>& cachedData) :
+    Plugin(gameType,
+           gameCache,
+           FindPluginFile(pluginPath),
+           headerOnly,
+           cachedData) {}
+
+Plugin::Plugin(const GameType gameType,
+               std::shared_ptr<GameCache> gameCache,
+               const DataFile& file,
+               const bool headerOnly,
+               const std::optional<PluginFileData>& cachedData) :
+    name_(file.name),
+    filenameKey_(file.name),
     esPlugin(nullptr),
     isEmpty_(true),
     loadsArchive_(false),
-    numOverrideRecords_(0) {
+    numOverrideRecords_(0),
+    headerOnly_(headerOnly) {
   auto logger = getLogger();
 
   try {
-    // In case the plugin is ghosted.
-    if (!std::filesystem::exists(pluginPath)) {
-      pluginPath += ".ghost";
-    }
+    const auto& pluginPath = file.path;
+    fileKey_ = file.key;
 
     Load(pluginPath, gameType, headerOnly);
 
@@ -64,7 +76,10 @@ Plugin::Plugin(const GameType gameType,
           "\" is empty. esplugin error code: " + std::to_string(ret));
     }
 
-    if (!headerOnly) {
+    if (!headerOnly && cachedData.has_value()) {
+      crc_ = cachedData.value().crc;
+      numOverrideRecords_ = cachedData.value().overrideRecordCount;
+    } else if (!headerOnly) {
       crc_ = GetCrc32(pluginPath);
 
       ret = esp_plugin_count_override_records(esPlugin.get(),
@@ -76,7 +91,7 @@ Plugin::Plugin(const GameType gameType,
       }
     }
 
-    tags_ = ExtractBashTags(GetDescription());
+    ReadHeader();
     loadsArchive_ = LoadsArchive(gameType, gameCache, pluginPath);
   } catch (std::exception& e) {
     if (logger) {
@@ -91,70 +106,33 @@ Plugin::Plugin(const GameType gameType,
 std::string Plugin::GetName() const { return name_; }
 
 float Plugin::GetHeaderVersion() const {
-  float version;
-  auto ret = esp_plugin_header_version(esPlugin.get(), &version);
-  if (ret != ESP_OK) {
-    throw FileAccessError(name_ +
-                          " : esplugin error code: " + std::to_string(ret));
+  if (!header_.headerVersion.has_value()) {
+    throw FileAccessError(name_ + " : the header version could not be read");
   }
 
-  return version;
+  return header_.headerVersion.value();
 }
 
+const FilenameKey& Plugin::GetFilenameKey() const { return filenameKey_; }
+
 std::optional<std::string> Plugin::GetVersion() const {
-  return ExtractVersion(GetDescription());
+  return header_.version;
 }
 
 std::vector<std::string> Plugin::GetMasters() const {
-  char** masters;
-  uint8_t numMasters;
-  auto ret = esp_plugin_masters(esPlugin.get(), &masters, &numMasters);
-  if (ret != ESP_OK) {
-    throw FileAccessError(name_ +
-                          " : esplugin error code: " + std::to_string(ret));
-  }
-
-  std::vector<std::string> mastersVec(masters, masters + numMasters);
-  esp_string_array_free(masters, numMasters);
-
-  return mastersVec;
+  return header_.masters;
 }
 
 std::set<Tag> Plugin::GetBashTags() const { return tags_; }
 
 std::optional<uint32_t> Plugin::GetCRC() const { return crc_; }
 
-bool Plugin::IsMaster() const {
-  bool isMaster;
-  auto ret = esp_plugin_is_master(esPlugin.get(), &isMaster);
-  if (ret != ESP_OK) {
-    throw FileAccessError(name_ +
-                          " : esplugin error code: " + std::to_string(ret));
-  }
-
-  return isMaster;
-}
+bool Plugin::IsMaster() const { return header_.isMaster; }
 
-bool Plugin::IsLightMaster() const {
-  bool isLightMaster;
-  auto ret = esp_plugin_is_light_master(esPlugin.get(), &isLightMaster);
-  if (ret != ESP_OK) {
-    throw FileAccessError(name_ +
-                          " : esplugin error code: " + std::to_string(ret));
-  }
-
-  return isLightMaster;
-}
+bool Plugin::IsLightMaster() const { return header_.isLightMaster; }
 
 bool Plugin::IsValidAsLightMaster() const {
-  bool isValid;
-  auto ret = esp_plugin_is_valid_as_light_master(esPlugin.get(), &isValid);
-  if (ret != ESP_OK) {
-    throw FileAccessError(name_ +
-                          " : esplugin error code: " + std::to_string(ret));
-  }
-
-  return isValid;
+  return header_.isValidAsLightMaster;
 }
 
 bool Plugin::IsEmpty() const { return isEmpty_; }
@@ -163,7 +141,7 @@ bool Plugin::LoadsArchive() const { return loadsArchive_; }
 
 bool Plugin::DoFormIDsOverlap(const PluginInterface& plugin) const {
   try {
-    auto otherPlugin = dynamic_cast<const Plugin&>(plugin);
+    const auto& otherPlugin = dynamic_cast<const Plugin&>(plugin);
 
     bool doPluginsOverlap;
     auto ret = esp_plugin_do_records_overlap(
@@ -208,6 +186,12 @@ size_t Plugin::GetOverlapSize(
   return overlapSize;
 }
 
+const PluginHeader& Plugin::GetHeader() const { return header_; }
+
+std::optional<PluginFileKey> Plugin::GetFileKey() const { return fileKey_; }
+
+bool Plugin::IsHeaderOnly() const { return headerOnly_; }
+
 size_t Plugin::NumOverrideFormIDs() const { return numOverrideRecords_; }
 
 uint32_t Plugin::GetRecordAndGroupCount() const { 
@@ -286,6 +270,53 @@ void Plugin::Load(const std::filesystem::path& path,
   }
 }
 
+void Plugin::ReadHeader() {
+  // A missing header version only matters if it's asked for, so don't fail
+  // to load the plugin because of it.
+  float headerVersion;
+  auto ret = esp_plugin_header_version(esPlugin.get(), &headerVersion);
+  if (ret == ESP_OK) {
+    header_.headerVersion = headerVersion;
+  }
+
+  char** masters;
+  uint8_t numMasters;
+  ret = esp_plugin_masters(esPlugin.get(), &masters, &numMasters);
+  if (ret != ESP_OK) {
+    throw FileAccessError(name_ +
+                          " : esplugin error code: " + std::to_string(ret));
+  }
+
+  header_.masters.assign(masters, masters + numMasters);
+  for (const auto& master : header_.masters) {
+    header_.masterKeys.push_back(FilenameKey(master));
+  }
+  esp_string_array_free(masters, numMasters);
+
+  ret = esp_plugin_is_master(esPlugin.get(), &header_.isMaster);
+  if (ret != ESP_OK) {
+    throw FileAccessError(name_ +
+                          " : esplugin error code: " + std::to_string(ret));
+  }
+
+  ret = esp_plugin_is_light_master(esPlugin.get(), &header_.isLightMaster);
+  if (ret != ESP_OK) {
+    throw FileAccessError(name_ +
+                          " : esplugin error code: " + std::to_string(ret));
+  }
+
+  ret = esp_plugin_is_valid_as_light_master(esPlugin.get(),
+                                            &header_.isValidAsLightMaster);
+  if (ret != ESP_OK) {
+    throw FileAccessError(name_ +
+                          " : esplugin error code: " + std::to_string(ret));
+  }
+
+  auto description = GetDescription();
+  header_.version = ExtractVersion(description);
+  tags_ = ExtractBashTags(description);
+}
+
 std::string Plugin::GetDescription() const {
   char* description;
   auto ret = esp_plugin_description(esPlugin.get(), &description);
@@ -352,29 +383,13 @@ bool Plugin::LoadsArchive(const GameType gameType,
 
   if (gameType == GameType::tes5) {
     // Skyrim plugins only load BSAs that exactly match their basename.
-    return std::filesystem::exists(
-        replaceExtension(pluginPath, archiveExtension));
+    return gameCache->HasArchive(
+        replaceExtension(pluginPath, archiveExtension).filename().u8string());
   } else if (gameType != GameType::tes4 ||
              boost::iends_with(pluginPath.filename().u8string(), ".esp")) {
     // Oblivion .esp files and FO3, FNV, FO4 plugins can load archives which
     // begin with the plugin basename.
-
-    auto basenameLength = pluginPath.stem().native().length();
-    auto pluginExtension = pluginPath.extension().native();
-
-    for (const auto& archivePath : gameCache->GetArchivePaths()) {
-      // Need to check if it starts with the given plugin's basename,
-      // but case insensitively. This is hard to do accurately, so
-      // instead check if the plugin with the same length basename and
-      // and the given plugin's file extension is equivalent.
-      auto bsaPluginFilename =
-          archivePath.filename().native().substr(0, basenameLength) +
-          pluginExtension;
-      auto bsaPluginPath = pluginPath.parent_path() / bsaPluginFilename;
-      if (loot::equivalent(pluginPath, bsaPluginPath)) {
-        return true;
-      }
-    }
+    return gameCache->HasArchiveWithPrefix(pluginPath.stem().u8string());
   }
 
   return false;
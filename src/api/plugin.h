@@ -33,7 +33,10 @@
 
 #include <esplugin.hpp>
 
+#include "api/game/data_directory_snapshot.h"
 #include "api/game/load_order_handler.h"
+#include "api/game/plugin_data_cache.h"
+#include "api/helpers/filename_key.h"
 #include "loot/enum/game_type.h"
 #include "loot/metadata/plugin_metadata.h"
 #include "loot/plugin_interface.h"
@@ -41,14 +44,37 @@
 namespace loot {
 class GameCache;
 
+// Facts read from a plugin's header when it is loaded, so that they can be
+// read during sorting without calling into esplugin or allocating.
+struct PluginHeader {
+  std::vector<std::string> masters;
+  std::vector<FilenameKey> masterKeys;
+  std::optional<std::string> version;  // Obtained from description field.
+  std::optional<float> headerVersion;
+  bool isMaster;
+  bool isLightMaster;
+  bool isValidAsLightMaster;
+};
+
 class Plugin : public PluginInterface {
 public:
+  // If cached data is given, it is used instead of calculating the plugin's
+  // CRC and counting its override records.
   explicit Plugin(const GameType gameType,
          std::shared_ptr<GameCache> gameCache,
          std::filesystem::path pluginPath,
-         const bool headerOnly);
+         const bool headerOnly,
+         const std::optional<PluginFileData>& cachedData = std::nullopt);
+
+  // Loads the given file without checking the filesystem for it again.
+  explicit Plugin(const GameType gameType,
+         std::shared_ptr<GameCache> gameCache,
+         const DataFile& file,
+         const bool headerOnly,
+         const std::optional<PluginFileData>& cachedData = std::nullopt);
 
   std::string GetName() const;
+  const FilenameKey& GetFilenameKey() const;
   float GetHeaderVersion() const;
   std::optional<std::string> GetVersion() const;
   std::vector<std::string> GetMasters() const;
@@ -64,6 +90,13 @@ public:
   size_t GetOverlapSize(
       const std::vector<std::shared_ptr<const Plugin>> plugins) const;
 
+  const PluginHeader& GetHeader() const;
+
+  // The file metadata read before the plugin was loaded, which can be
+  // compared against the file's current metadata to check if it has changed.
+  std::optional<PluginFileKey> GetFileKey() const;
+  bool IsHeaderOnly() const;
+
   // Load ordering functions.
   size_t NumOverrideFormIDs() const;
   uint32_t GetRecordAndGroupCount() const;
@@ -79,6 +112,7 @@ private:
   void Load(const std::filesystem::path& path,
             GameType gameType,
             bool headerOnly);
+  void ReadHeader();
   std::string GetDescription() const;
 
   static bool LoadsArchive(const GameType gameType,
@@ -90,12 +124,15 @@ private:
                   // header?
   bool loadsArchive_;
   const std::string name_;
-  std::optional<std::string> version_;  // Obtained from description field.
+  const FilenameKey filenameKey_;
   std::optional<uint32_t> crc_;
   std::set<Tag> tags_;
+  PluginHeader header_;
 
   // Useful caches.
   size_t numOverrideRecords_;
+  std::optional<PluginFileKey> fileKey_;
+  bool headerOnly_;
 
   std::shared_ptr<std::remove_pointer<::Plugin>::type> esPlugin;
 };
@@ -24,12 +24,14 @@
 
 #include "plugin_graph.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
+#include <functional>
 #include <queue>
+#include <unordered_map>
 
 #include <boost/algorithm/string.hpp>
-#include <boost/graph/breadth_first_search.hpp>
-#include <boost/graph/iteration_macros.hpp>
 #include <boost/graph/topological_sort.hpp>
 
 #include "api/game/game.h"
@@ -44,20 +46,19 @@ using std::string;
 using std::vector;
 
 namespace loot {
-typedef boost::graph_traits<RawPluginGraph>::vertex_iterator vertex_it;
 typedef boost::graph_traits<RawPluginGraph>::edge_descriptor edge_t;
 typedef boost::graph_traits<RawPluginGraph>::edge_iterator edge_it;
 
 class CycleDetector : public boost::dfs_visitor<> {
 public:
+  explicit CycleDetector(size_t pluginCount) : pluginCount_(pluginCount) {}
+
   void tree_edge(edge_t edge, const RawPluginGraph& graph) {
     auto source = boost::source(edge, graph);
 
-    auto vertex = Vertex(graph[source].GetName(), graph[edge]);
-
     // Check if the vertex already exists in the recorded trail.
-    auto it = find_if(begin(trail), end(trail), [&](const Vertex& v) {
-      return v.GetName() == graph[source].GetName();
+    auto it = find_if(begin(trail), end(trail), [&](const auto& step) {
+      return step.first == source;
     });
 
     if (it != end(trail)) {
@@ -66,27 +67,37 @@ public:
       trail.erase(it, end(trail));
     }
 
-    trail.push_back(vertex);
+    trail.push_back(std::make_pair(source, graph[edge]));
   }
 
   void back_edge(edge_t edge, const RawPluginGraph& graph) {
     auto source = boost::source(edge, graph);
     auto target = boost::target(edge, graph);
 
-    auto vertex = Vertex(graph[source].GetName(), graph[edge]);
-    trail.push_back(vertex);
+    trail.push_back(std::make_pair(source, graph[edge]));
 
-    auto it = find_if(begin(trail), end(trail), [&](const Vertex& v) {
-      return v.GetName() == graph[target].GetName();
+    auto it = find_if(begin(trail), end(trail), [&](const auto& step) {
+      return step.first == target;
     });
 
     if (it != trail.end()) {
-      throw CyclicInteractionError(std::vector<Vertex>(it, trail.end()));
+      // Group vertices stand in for group edges between plugins, so leave
+      // them out: the plugin before a group vertex has a group edge to the
+      // next plugin in the cycle.
+      std::vector<Vertex> cycle;
+      for (; it != trail.end(); ++it) {
+        if (it->first < pluginCount_) {
+          cycle.push_back(Vertex(graph[it->first].GetName(), it->second));
+        }
+      }
+
+      throw CyclicInteractionError(cycle);
     }
   }
 
 private:
-  std::vector<Vertex> trail;
+  const size_t pluginCount_;
+  std::vector<std::pair<vertex_t, EdgeType>> trail;
 };
 
 std::string describeEdgeType(EdgeType edgeType) {
@@ -116,56 +127,55 @@ std::string describeEdgeType(EdgeType edgeType) {
   }
 }
 
-size_t PluginGraph::CountVertices() const {
-  return boost::num_vertices(graph_);
+PluginGraph::PluginGraph() :
+    pluginCount_(0),
+    monitor_(nullptr),
+    cycleChecks_(0),
+    cyclicEdgesSkipped_(0),
+    overlapChecks_(0) {}
+
+PluginGraph::PluginGraph(const OperationMonitor& monitor) : PluginGraph() {
+  monitor_ = &monitor;
 }
 
+size_t PluginGraph::CountVertices() const { return pluginCount_; }
+
 std::vector<std::string> PluginGraph::TopologicalSort() const {
-  // Build an index map, which std::list-based VertexList graphs don't have.
-  std::map<vertex_t, size_t> indexMap;
-  auto vertexIndexMap = vertex_map_t(indexMap);
-  size_t i = 0;
-  BGL_FORALL_VERTICES(v, graph_, RawPluginGraph) {
-    put(vertexIndexMap, v, i++);
-  }
+  std::vector<vertex_t> sortedVertices;
+  sortedVertices.reserve(boost::num_vertices(graph_));
 
-  std::list<vertex_t> sortedVertices;
   auto logger = getLogger();
   if (logger) {
     logger->trace("Performing topological sort on plugin graph...");
   }
-  boost::topological_sort(graph_,
-                          std::front_inserter(sortedVertices),
-                          boost::vertex_index_map(vertexIndexMap));
-
-  // Check that the sorted path is Hamiltonian (ie. unique).
+  // topological_sort() outputs vertices in reverse topological order.
+  boost::topological_sort(graph_, std::back_inserter(sortedVertices));
+  std::reverse(sortedVertices.begin(), sortedVertices.end());
+
+  sortedVertices.erase(std::remove_if(sortedVertices.begin(),
+                                      sortedVertices.end(),
+                                      [&](const vertex_t& vertex) {
+                                        return vertex >= pluginCount_;
+                                      }),
+                       sortedVertices.end());
+
+  // Check that the sorted path is Hamiltonian (ie. unique). Adjacent plugins
+  // may be linked through group vertices instead of by an edge.
   if (logger) {
     logger->trace("Checking uniqueness of calculated load order...");
   }
   for (auto it = sortedVertices.begin(); it != sortedVertices.end(); ++it) {
-    if (next(it) != sortedVertices.end() &&
-        !boost::edge(*it, *next(it), graph_).second && logger) {
+    if (next(it) != sortedVertices.end() && !PathExists(*it, *next(it)) &&
+        logger) {
       logger->error(
-          "The calculated load order is not unique. No edge exists between {} "
+          "The calculated load order is not unique. No path exists between {} "
           "and {}.",
           graph_[*it].GetName(),
           graph_[*next(it)].GetName());
     }
   }
 
-  // Output a plugin list using the sorted vertices.
-  if (logger) {
-    logger->info("Calculated order: ");
-  }
-  vector<std::string> plugins;
-  for (const auto& vertex : sortedVertices) {
-    plugins.push_back(graph_[vertex].GetName());
-    if (logger) {
-      logger->info("\t{}", plugins.back());
-    }
-  }
-
-  return plugins;
+  return GetPluginNames(sortedVertices);
 }
 
 void PluginGraph::AddPluginVertices(Game& game,
@@ -173,8 +183,8 @@ void PluginGraph::AddPluginVertices(Game& game,
   // The resolution of tie-breaks in the plugin graph may be dependent
   // on the order in which vertices are iterated over, as an earlier tie
   // break resolution may cause a potential later tie break to instead
-  // cause a cycle. Vertices are stored in a std::list and added to the
-  // list using push_back().
+  // cause a cycle. Vertices are stored in a std::vector and added to the
+  // vector using push_back().
   // Plugins are stored in an unordered map, so simply iterating over
   // its elements is not guarunteed to produce a consistent vertex order.
   // MSVC 2013 and GCC 5.0 have been shown to produce consistent
@@ -188,12 +198,11 @@ void PluginGraph::AddPluginVertices(Game& game,
   // unspecified behaviour will remain in future compiler updates, so
   // implement it generally.
 
-  // Using a set of plugin names followed by finding the matching key
-  // in the unordered map, as it's probably faster than copying the
-  // full plugin objects then sorting them.
-  std::map<std::string, std::vector<std::string>> groupPlugins;
-
-  auto loadedPlugins = game.GetCache()->GetPlugins();
+  // Use the cache's snapshot of the loaded plugins, which is already sorted
+  // by filename.
+  auto snapshot = game.GetCache()->GetPluginsSnapshot();
+  const auto& loadedPlugins = snapshot->plugins;
+  const auto loadOrderIndexes = GetLoadOrderIndexes(loadOrder);
   for (const auto& plugin : loadedPlugins) {
     auto masterlistMetadata =
         game.GetDatabase()
@@ -206,71 +215,97 @@ void PluginGraph::AddPluginVertices(Game& game,
     auto pluginSortingData = PluginSortingData(*plugin,
                                                masterlistMetadata,
                                                userMetadata,
-                                               loadOrder,
+                                               loadOrderIndexes,
                                                game.Type(),
                                                loadedPlugins);
 
-    auto groupName = pluginSortingData.GetGroup();
-    auto groupIt = groupPlugins.find(groupName);
-    if (groupIt == groupPlugins.end()) {
-      groupPlugins.emplace(groupName,
-                           std::vector<std::string>({plugin->GetName()}));
-    } else {
-      groupIt->second.push_back(plugin->GetName());
-    }
-
-    boost::add_vertex(pluginSortingData, graph_);
+    auto vertex = boost::add_vertex(pluginSortingData, graph_);
+    verticesByName_.emplace(plugin->GetFilenameKey(), vertex);
   }
 
-  // Map sets of transitive group dependencies to sets of transitive plugin
-  // dependencies.
-  auto groups = GetTransitiveAfterGroups(game.GetDatabase()->GetGroups(false),
-                                         game.GetDatabase()->GetUserGroups());
-  for (auto& group : groups) {
-    std::unordered_set<std::string> transitivePlugins;
-    for (const auto& afterGroup : group.second) {
-      auto pluginsIt = groupPlugins.find(afterGroup);
-      if (pluginsIt != groupPlugins.end()) {
-        transitivePlugins.insert(pluginsIt->second.begin(),
-                                 pluginsIt->second.end());
-      }
-    }
-    group.second = transitivePlugins;
-  }
+  pluginCount_ = boost::num_vertices(graph_);
 
-  // Add all transitive plugin dependencies for a group to the plugin's load
-  // after metadata.
   auto logger = getLogger();
-  for (const auto& vertex :
-       boost::make_iterator_range(boost::vertices(graph_))) {
-    PluginSortingData& plugin = graph_[vertex];
+  transitiveAfterGroups_ =
+      GetTransitiveAfterGroups(game.GetDatabase()->GetGroups(false),
+                               game.GetDatabase()->GetUserGroups());
+  for (const auto& vertex : boost::make_iterator_range(PluginVertices())) {
+    const PluginSortingData& plugin = graph_[vertex];
 
     if (logger) {
-      logger->trace(
-          "Plugin \"{}\" belongs to group \"{}\", setting after group plugins",
-          plugin.GetName(),
-          plugin.GetGroup());
+      logger->trace("Plugin \"{}\" belongs to group \"{}\"",
+                    plugin.GetName(),
+                    plugin.GetGroup());
     }
 
-    auto groupsIt = groups.find(plugin.GetGroup());
-    if (groupsIt == groups.end()) {
+    if (transitiveAfterGroups_.count(plugin.GetGroup()) == 0) {
       throw UndefinedGroupError(plugin.GetGroup());
-    } else {
-      plugin.SetAfterGroupPlugins(groupsIt->second);
     }
   }
+
+  // Add start and end vertices for each group after the plugin vertices, in
+  // name order so that the vertex order is consistent.
+  std::vector<std::string> groupNames;
+  for (const auto& group : transitiveAfterGroups_) {
+    groupNames.push_back(group.first);
+  }
+  std::sort(groupNames.begin(), groupNames.end());
+
+  for (const auto& groupName : groupNames) {
+    GroupVertices groupVertices;
+    groupVertices.start = boost::add_vertex(graph_);
+    groupVertexNames_.push_back("start of group \"" + groupName + "\"");
+    groupVertices.end = boost::add_vertex(graph_);
+    groupVertexNames_.push_back("end of group \"" + groupName + "\"");
+
+    groupVertices_.emplace(groupName, groupVertices);
+  }
+
+  const auto vertexCount = boost::num_vertices(graph_);
+  outEdges_.assign(vertexCount, boost::dynamic_bitset<>(vertexCount));
+  descendants_.assign(vertexCount, boost::dynamic_bitset<>(vertexCount));
+  ancestors_.assign(vertexCount, boost::dynamic_bitset<>(vertexCount));
+}
+
+void PluginGraph::ThrowIfCancelled() const {
+  if (monitor_) {
+    monitor_->ThrowIfCancelled();
+  }
 }
 
 std::optional<vertex_t> PluginGraph::GetVertexByName(
     const std::string& name) const {
-  for (const auto& vertex :
-       boost::make_iterator_range(boost::vertices(graph_))) {
-    if (CompareFilenames(graph_[vertex].GetName(), name) == 0) {
-      return vertex;
-    }
+  auto it = FindFilename(verticesByName_, name);
+  if (it == verticesByName_.end()) {
+    return std::nullopt;
+  }
+
+  return it->second;
+}
+
+std::optional<vertex_t> PluginGraph::GetVertexByKey(
+    const FilenameKey& key) const {
+  auto it = verticesByName_.find(key);
+  if (it == verticesByName_.end()) {
+    return std::nullopt;
+  }
+
+  return it->second;
+}
+
+std::pair<vertex_it, vertex_it> PluginGraph::PluginVertices() const {
+  auto vertices = boost::vertices(graph_);
+  vertices.second = vertices.first + pluginCount_;
+
+  return vertices;
+}
+
+std::string PluginGraph::GetVertexName(const vertex_t& vertex) const {
+  if (vertex < pluginCount_) {
+    return graph_[vertex].GetName();
   }
 
-  return std::nullopt;
+  return groupVertexNames_.at(vertex - pluginCount_);
 }
 
 void PluginGraph::CheckForCycles() const {
@@ -279,69 +314,45 @@ void PluginGraph::CheckForCycles() const {
     logger->trace("Checking plugin graph for cycles...");
   }
 
-  std::map<vertex_t, size_t> indexMap;
-  auto vertexIndexMap = vertex_map_t(indexMap);
-  size_t i = 0;
-  BGL_FORALL_VERTICES(v, graph_, RawPluginGraph) {
-    put(vertexIndexMap, v, i++);
-  }
-
-  boost::depth_first_search(
-      graph_, visitor(CycleDetector()).vertex_index_map(vertexIndexMap));
+  boost::depth_first_search(graph_,
+                            boost::visitor(CycleDetector(pluginCount_)));
 }
 
-bool PluginGraph::EdgeCreatesCycle(const vertex_t& fromVertex,
-                                   const vertex_t& toVertex) {
-  if (pathsCache_.count(GraphPath(toVertex, fromVertex)) != 0) {
-    return true;
+std::vector<std::string> PluginGraph::GetPluginNames(
+    const std::vector<vertex_t>& sortedVertices) const {
+  // Output a plugin list using the sorted vertices.
+  auto logger = getLogger();
+  if (logger) {
+    logger->info("Calculated order: ");
+  }
+  vector<std::string> plugins;
+  for (const auto& vertex : sortedVertices) {
+    plugins.push_back(graph_[vertex].GetName());
+    if (logger) {
+      logger->info("\t{}", plugins.back());
+    }
   }
 
-  auto start = toVertex;
-  auto end = fromVertex;
-
-  std::queue<vertex_t> forwardQueue;
-  std::queue<vertex_t> reverseQueue;
-  std::unordered_set<vertex_t> forwardVisited;
-  std::unordered_set<vertex_t> reverseVisited;
+  return plugins;
+}
 
-  forwardQueue.push(start);
-  forwardVisited.insert(start);
-  reverseQueue.push(end);
-  reverseVisited.insert(end);
+bool PluginGraph::HasEdge(const vertex_t& fromVertex,
+                          const vertex_t& toVertex) const {
+  return outEdges_[fromVertex].test(toVertex);
+}
 
-  while (!forwardQueue.empty() && !reverseQueue.empty()) {
-    if (!forwardQueue.empty()) {
-      auto v = forwardQueue.front();
-      forwardQueue.pop();
-      if (v == end || reverseVisited.count(v) > 0) {
-        return true;
-      }
-      for (auto adjacentV :
-           boost::make_iterator_range(boost::adjacent_vertices(v, graph_))) {
-        if (forwardVisited.count(adjacentV) == 0) {
-          pathsCache_.insert(GraphPath(start, adjacentV));
+bool PluginGraph::PathExists(const vertex_t& fromVertex,
+                             const vertex_t& toVertex) const {
+  return descendants_[fromVertex].test(toVertex);
+}
 
-          forwardVisited.insert(adjacentV);
-          forwardQueue.push(adjacentV);
-        }
-      }
-    }
-    if (!reverseQueue.empty()) {
-      auto v = reverseQueue.front();
-      reverseQueue.pop();
-      if (v == start || forwardVisited.count(v) > 0) {
-        return true;
-      }
-      for (auto adjacentV : boost::make_iterator_range(
-               boost::inv_adjacent_vertices(v, graph_))) {
-        if (reverseVisited.count(adjacentV) == 0) {
-          pathsCache_.insert(GraphPath(adjacentV, end));
+bool PluginGraph::EdgeCreatesCycle(const vertex_t& fromVertex,
+                                   const vertex_t& toVertex) {
+  cycleChecks_ += 1;
 
-          reverseVisited.insert(adjacentV);
-          reverseQueue.push(adjacentV);
-        }
-      }
-    }
+  if (fromVertex == toVertex || PathExists(toVertex, fromVertex)) {
+    cyclicEdgesSkipped_ += 1;
+    return true;
   }
 
   return false;
@@ -350,9 +361,7 @@ bool PluginGraph::EdgeCreatesCycle(const vertex_t& fromVertex,
 void PluginGraph::AddEdge(const vertex_t& fromVertex,
                           const vertex_t& toVertex,
                           EdgeType edgeType) {
-  auto graphPath = GraphPath(fromVertex, toVertex);
-
-  if (pathsCache_.count(graphPath) != 0) {
+  if (HasEdge(fromVertex, toVertex)) {
     return;
   }
 
@@ -360,38 +369,71 @@ void PluginGraph::AddEdge(const vertex_t& fromVertex,
   if (logger) {
     logger->trace("Adding {} edge from \"{}\" to \"{}\".",
                   describeEdgeType(edgeType),
-                  graph_[fromVertex].GetName(),
-                  graph_[toVertex].GetName());
+                  GetVertexName(fromVertex),
+                  GetVertexName(toVertex));
   }
 
   boost::add_edge(fromVertex, toVertex, edgeType, graph_);
-  pathsCache_.insert(graphPath);
+  outEdges_[fromVertex].set(toVertex);
+  edgesAdded_[edgeType] += 1;
+
+  // If there was already a path between the two vertices, the new edge
+  // doesn't make anything newly reachable.
+  if (PathExists(fromVertex, toVertex)) {
+    return;
+  }
+
+  // Everything that could reach fromVertex (including itself) can now reach
+  // everything that toVertex could reach (including itself).
+  auto newDescendants = descendants_[toVertex];
+  newDescendants.set(toVertex);
+  auto newAncestors = ancestors_[fromVertex];
+  newAncestors.set(fromVertex);
+
+  for (auto v = newAncestors.find_first(); v != boost::dynamic_bitset<>::npos;
+       v = newAncestors.find_next(v)) {
+    descendants_[v] |= newDescendants;
+  }
+
+  for (auto v = newDescendants.find_first();
+       v != boost::dynamic_bitset<>::npos;
+       v = newDescendants.find_next(v)) {
+    ancestors_[v] |= newAncestors;
+  }
 }
 
 void PluginGraph::AddHardcodedPluginEdges(Game& game) {
-  using std::filesystem::u8path;
-
   auto implicitlyActivePlugins =
       game.GetLoadOrderHandler()->GetImplicitlyActivePlugins();
 
+  // Files are identified by their paths in the data directory snapshot, which
+  // resolves differences in case and ghosting, so each plugin's file only
+  // needs to be looked up once.
+  auto snapshot = game.GetDataDirectorySnapshot();
+  std::vector<std::optional<std::filesystem::path>> vertexPaths(pluginCount_);
+  for (const auto& vertex : boost::make_iterator_range(PluginVertices())) {
+    auto file = snapshot->FindPlugin(graph_[vertex].GetName());
+    if (file.has_value()) {
+      vertexPaths[vertex] = file.value().path;
+    }
+  }
+
   auto logger = getLogger();
   std::set<std::filesystem::path> processedPluginPaths;
   for (const auto& plugin : implicitlyActivePlugins) {
-    auto pluginPath = game.DataPath() / u8path(plugin);
-
-    try {
-      processedPluginPaths.insert(std::filesystem::canonical(pluginPath));
-    } catch (std::filesystem::filesystem_error& e) {
+    auto pluginFile = snapshot->FindFile(plugin);
+    if (!pluginFile.has_value()) {
       if (logger) {
         logger->trace(
-            "Skipping adding hardcoded plugin edges for \"{}\" as its "
-            "canonical path could not be determined: {}",
-            plugin,
-            e.what());
+            "Skipping adding hardcoded plugin edges for \"{}\" as it is not "
+            "in the data directory.",
+            plugin);
       }
       continue;
     }
 
+    processedPluginPaths.insert(pluginFile.value().path);
+
     if (game.Type() == GameType::tes5 &&
         loot::equivalent(plugin, "update.esm")) {
       if (logger) {
@@ -415,20 +457,14 @@ void PluginGraph::AddHardcodedPluginEdges(Game& game) {
     }
 
     vertex_it vit, vitend;
-    for (tie(vit, vitend) = boost::vertices(graph_); vit != vitend; ++vit) {
-      auto& graphPlugin = graph_[*vit];
-
-      auto graphPluginPath = game.DataPath() / u8path(graphPlugin.GetName());
-      if (!std::filesystem::exists(graphPluginPath)) {
-        graphPluginPath += ".ghost";
-      }
-
-      if (!std::filesystem::exists(graphPluginPath)) {
+    for (std::tie(vit, vitend) = PluginVertices(); vit != vitend;
+         ++vit) {
+      const auto& graphPluginPath = vertexPaths[*vit];
+      if (!graphPluginPath.has_value()) {
         continue;
       }
 
-      if (processedPluginPaths.count(
-              std::filesystem::canonical(graphPluginPath)) == 0) {
+      if (processedPluginPaths.count(graphPluginPath.value()) == 0) {
         AddEdge(pluginVertex.value(), *vit, EdgeType::hardcoded);
       }
     }
@@ -438,7 +474,9 @@ void PluginGraph::AddHardcodedPluginEdges(Game& game) {
 void PluginGraph::AddSpecificEdges() {
   // Add edges for all relationships that aren't overlaps.
   vertex_it vit, vitend;
-  for (tie(vit, vitend) = boost::vertices(graph_); vit != vitend; ++vit) {
+  for (std::tie(vit, vitend) = PluginVertices(); vit != vitend; ++vit) {
+    ThrowIfCancelled();
+
     for (vertex_it vit2 = vit; vit2 != vitend; ++vit2) {
       if (graph_[*vit].IsMaster() == graph_[*vit2].IsMaster())
         continue;
@@ -455,8 +493,8 @@ void PluginGraph::AddSpecificEdges() {
       AddEdge(parentVertex, vertex, EdgeType::masterFlag);
     }
 
-    for (const auto& master : graph_[*vit].GetMasters()) {
-      auto parentVertex = GetVertexByName(master);
+    for (const auto& master : graph_[*vit].GetMasterKeys()) {
+      auto parentVertex = GetVertexByKey(master);
       if (parentVertex.has_value()) {
         AddEdge(parentVertex.value(), *vit, EdgeType::master);
       }
@@ -592,65 +630,156 @@ std::unordered_set<std::string> getGroupsInPaths(
 }
 
 void PluginGraph::AddGroupEdges(const std::unordered_set<Group>& groups) {
-  std::vector<std::pair<vertex_t, vertex_t>> acyclicEdgePairs;
+  const auto vertexCount = boost::num_vertices(graph_);
+
+  // Get the plugins that load before each group due to their own groups.
+  std::unordered_map<std::string, boost::dynamic_bitset<>> groupPlugins;
+  for (const auto& vertex : boost::make_iterator_range(PluginVertices())) {
+    auto& plugins = groupPlugins[graph_[vertex].GetGroup()];
+    plugins.resize(vertexCount);
+    plugins.set(vertex);
+  }
+
+  std::unordered_map<std::string, boost::dynamic_bitset<>> earlierPlugins;
+  for (const auto& group : transitiveAfterGroups_) {
+    boost::dynamic_bitset<> plugins(vertexCount);
+    for (const auto& afterGroup : group.second) {
+      auto pluginsIt = groupPlugins.find(afterGroup);
+      if (pluginsIt != groupPlugins.end()) {
+        plugins |= pluginsIt->second;
+      }
+    }
+    earlierPlugins.emplace(group.first, plugins);
+  }
+
+  // Plugins that are involved in a group edge that is skipped can't be linked
+  // through their group's vertices, as that would imply the skipped edge, so
+  // record them so that they can be linked to other plugins individually.
   std::map<std::string, std::unordered_set<std::string>> groupPluginsToIgnore;
+  boost::dynamic_bitset<> unlinkedPredecessors(vertexCount);
+  boost::dynamic_bitset<> unlinkedSuccessors(vertexCount);
 
   auto logger = getLogger();
-  for (const vertex_t& vertex :
-       boost::make_iterator_range(boost::vertices(graph_))) {
-    for (const auto& pluginName : graph_[vertex].GetAfterGroupPlugins()) {
-      auto parentVertex = GetVertexByName(pluginName);
-      if (!parentVertex.has_value()) {
+  for (const auto& vertex : boost::make_iterator_range(PluginVertices())) {
+    ThrowIfCancelled();
+
+    // A group edge would create a cycle if the later plugin can already
+    // reach the earlier plugin.
+    auto cyclicParents = descendants_[vertex] &
+                         earlierPlugins.at(graph_[vertex].GetGroup());
+    for (auto parentVertex = cyclicParents.find_first();
+         parentVertex != boost::dynamic_bitset<>::npos;
+         parentVertex = cyclicParents.find_next(parentVertex)) {
+      auto& fromPlugin = graph_[parentVertex];
+      auto& toPlugin = graph_[vertex];
+
+      unlinkedSuccessors.set(vertex);
+
+      if (logger) {
+        logger->trace(
+            "Skipping group edge from \"{}\" to \"{}\" as it would "
+            "create a cycle.",
+            fromPlugin.GetName(),
+            toPlugin.GetName());
+      }
+
+      // If the earlier plugin is not a master and the later plugin is,
+      // don't ignore the plugin with the default group for all
+      // intermediate plugins, as some of those plugins may be masters
+      // that wouldn't be involved in the cycle, and any of those
+      // plugins that are not masters would have their own cycles
+      // detected anyway.
+      if (!fromPlugin.IsMaster() && toPlugin.IsMaster()) {
         continue;
       }
 
-      if (EdgeCreatesCycle(parentVertex.value(), vertex)) {
-        auto& fromPlugin = graph_[parentVertex.value()];
-        auto& toPlugin = graph_[vertex];
+      // The default group is a special case, as it's given to plugins
+      // with no metadata. If a plugin in the default group causes
+      // a cycle due to its group, ignore that plugin's group for all
+      // groups in the group graph paths between default and the other
+      // plugin's group.
+      std::string pluginToIgnore;
+      if (toPlugin.GetGroup() == Group().GetName()) {
+        pluginToIgnore = toPlugin.GetName();
+      } else if (fromPlugin.GetGroup() == Group().GetName()) {
+        pluginToIgnore = fromPlugin.GetName();
+      } else {
+        // If neither plugin is in the default group, it's impossible
+        // to decide which group to ignore, so ignore neither of them.
+        continue;
+      }
 
-        if (logger) {
-          logger->trace(
-              "Skipping group edge from \"{}\" to \"{}\" as it would "
-              "create a cycle.",
-              fromPlugin.GetName(),
-              toPlugin.GetName());
-        }
+      auto groupsInPaths = getGroupsInPaths(
+          groups, fromPlugin.GetGroup(), toPlugin.GetGroup());
 
-        // If the earlier plugin is not a master and the later plugin is,
-        // don't ignore the plugin with the default group for all
-        // intermediate plugins, as some of those plugins may be masters
-        // that wouldn't be involved in the cycle, and any of those
-        // plugins that are not masters would have their own cycles
-        // detected anyway.
-        if (!fromPlugin.IsMaster() && toPlugin.IsMaster()) {
-          continue;
-        }
+      ignorePlugin(pluginToIgnore, groupsInPaths, groupPluginsToIgnore);
+    }
+  }
 
-        // The default group is a special case, as it's given to plugins
-        // with no metadata. If a plugin in the default group causes
-        // a cycle due to its group, ignore that plugin's group for all
-        // groups in the group graph paths between default and the other
-        // plugin's group.
-        std::string pluginToIgnore;
-        if (toPlugin.GetGroup() == Group().GetName()) {
-          pluginToIgnore = toPlugin.GetName();
-        } else if (fromPlugin.GetGroup() == Group().GetName()) {
-          pluginToIgnore = fromPlugin.GetName();
-        } else {
-          // If neither plugin is in the default group, it's impossible
-          // to decide which group to ignore, so ignore neither of them.
-          continue;
-        }
+  for (const auto& pluginsToIgnore : groupPluginsToIgnore) {
+    for (const auto& pluginName : pluginsToIgnore.second) {
+      auto vertex = GetVertexByName(pluginName);
+      if (vertex.has_value()) {
+        unlinkedPredecessors.set(vertex.value());
+        unlinkedSuccessors.set(vertex.value());
+      }
+    }
+  }
 
-        auto groupsInPaths = getGroupsInPaths(
-            groups, fromPlugin.GetGroup(), toPlugin.GetGroup());
+  // Find the group edges that involve unlinked plugins before adding any
+  // edges, so that cycle checks are made against the same graph as above.
+  std::vector<std::pair<vertex_t, vertex_t>> acyclicEdgePairs;
+  for (const auto& vertex : boost::make_iterator_range(PluginVertices())) {
+    auto parentVertices = earlierPlugins.at(graph_[vertex].GetGroup());
+    if (!unlinkedSuccessors.test(vertex)) {
+      parentVertices &= unlinkedPredecessors;
+    }
 
-        ignorePlugin(pluginToIgnore, groupsInPaths, groupPluginsToIgnore);
+    for (auto parentVertex = parentVertices.find_first();
+         parentVertex != boost::dynamic_bitset<>::npos;
+         parentVertex = parentVertices.find_next(parentVertex)) {
+      if (!EdgeCreatesCycle(parentVertex, vertex)) {
+        acyclicEdgePairs.push_back(std::make_pair(parentVertex, vertex));
+      }
+    }
+  }
 
-        continue;
+  // Link the group vertices. The end vertex of each of a group's after groups
+  // has an edge to the group's end vertex, and then to its start vertex, so
+  // that the end vertex of a group can be reached from all plugins in earlier
+  // groups, and the start vertex of a group can reach all its plugins.
+  std::vector<std::pair<vertex_t, vertex_t>> startEdgePairs;
+  for (const auto& group : groups) {
+    auto groupVerticesIt = groupVertices_.find(group.GetName());
+    if (groupVerticesIt == groupVertices_.end()) {
+      continue;
+    }
+
+    for (const auto& afterGroupName : group.GetAfterGroups()) {
+      auto afterGroupVerticesIt = groupVertices_.find(afterGroupName);
+      if (afterGroupVerticesIt != groupVertices_.end()) {
+        AddEdge(afterGroupVerticesIt->second.end,
+                groupVerticesIt->second.end,
+                EdgeType::group);
+        startEdgePairs.push_back(std::make_pair(
+            afterGroupVerticesIt->second.end, groupVerticesIt->second.start));
       }
+    }
+  }
+
+  for (const auto& edgePair : startEdgePairs) {
+    AddEdge(edgePair.first, edgePair.second, EdgeType::group);
+  }
+
+  for (const auto& vertex : boost::make_iterator_range(PluginVertices())) {
+    const auto& groupVertices = groupVertices_.at(graph_[vertex].GetGroup());
 
-      acyclicEdgePairs.push_back(std::make_pair(parentVertex.value(), vertex));
+    if (!unlinkedPredecessors.test(vertex)) {
+      AddEdge(vertex, groupVertices.end, EdgeType::group);
+    }
+
+    if (!unlinkedSuccessors.test(vertex)) {
+      AddEdge(groupVertices.start, vertex, EdgeType::group);
     }
   }
 
@@ -672,10 +801,125 @@ void PluginGraph::AddGroupEdges(const std::unordered_set<Group>& groups) {
   }
 }
 
-void PluginGraph::AddOverlapEdges() {
+std::vector<FilenameKey> GetRecordNamespaces(
+    const PluginSortingData& plugin) {
+  // FormIDs are resolved against a plugin's masters and the plugin itself,
+  // so those are the only plugins that its records can belong to.
+  auto namespaces = plugin.GetMasterKeys();
+  namespaces.push_back(plugin.GetFilenameKey());
+
+  return namespaces;
+}
+
+std::vector<std::vector<vertex_t>> PluginGraph::FindOverlappingVertices(
+    const GameType gameType,
+    ThreadPool& threadPool) {
+  const auto vertexCount = boost::num_vertices(graph_);
+
+  // Two plugins can only share FormIDs if their records belong to a common
+  // plugin, so index the vertices by the plugins their records can belong to
+  // and only check pairs that share an index entry. Morrowind records are
+  // identified by their IDs rather than by FormIDs, so all pairs must be
+  // checked for Morrowind.
+  std::unordered_map<FilenameKey, boost::dynamic_bitset<>> verticesByNamespace;
+  if (gameType != GameType::tes3) {
+    vertex_it vit, vitend;
+    for (std::tie(vit, vitend) = PluginVertices(); vit != vitend;
+         ++vit) {
+      for (const auto& name : GetRecordNamespaces(graph_[*vit])) {
+        auto& vertices = verticesByNamespace[name];
+        vertices.resize(vertexCount);
+        vertices.set(*vit);
+      }
+    }
+  }
+
+  // Checking for overlap only reads plugin data, so the checks can be spread
+  // across the pool's threads. Each vertex's overlapping vertices are only
+  // written by the task that claims that vertex, and are found in vertex
+  // order.
+  std::vector<std::vector<vertex_t>> overlappingVertices(pluginCount_);
+  std::atomic<vertex_t> nextVertex(0);
+  std::atomic<size_t> overlapChecks(0);
+  auto findOverlaps = [&]() {
+    for (vertex_t vertex = nextVertex++; vertex < pluginCount_;
+         vertex = nextVertex++) {
+      // Stop early if cancelled. This is checked again once all the tasks
+      // have finished.
+      if (monitor_ && monitor_->IsCancelled()) {
+        break;
+      }
+
+      if (graph_[vertex].NumOverrideFormIDs() == 0) {
+        continue;
+      }
+
+      boost::dynamic_bitset<> candidates(vertexCount);
+      if (gameType == GameType::tes3) {
+        candidates.set();
+      } else {
+        for (const auto& name : GetRecordNamespaces(graph_[vertex])) {
+          candidates |= verticesByNamespace.at(name);
+        }
+      }
+
+      for (vertex_t otherVertex = vertex + 1; otherVertex < pluginCount_;
+           ++otherVertex) {
+        if (!candidates.test(otherVertex) || HasEdge(vertex, otherVertex) ||
+            HasEdge(otherVertex, vertex) ||
+            graph_[vertex].NumOverrideFormIDs() ==
+                graph_[otherVertex].NumOverrideFormIDs()) {
+          continue;
+        }
+
+        overlapChecks++;
+        if (!graph_[vertex].DoFormIDsOverlap(graph_[otherVertex])) {
+          continue;
+        }
+
+        overlappingVertices[vertex].push_back(otherVertex);
+      }
+    }
+  };
+
+  // Earlier vertices are checked against more later vertices, so each task
+  // claims the next unchecked vertex rather than a fixed range of vertices.
+  const auto tasksToRun =
+      std::max(std::min(threadPool.ThreadCount(), pluginCount_), (size_t)1);
+
   auto logger = getLogger();
+  if (logger) {
+    logger->trace("Checking for overlapping plugins using {} threads.",
+                  tasksToRun);
+  }
+
+  std::vector<std::function<void()>> tasks(tasksToRun, findOverlaps);
+  try {
+    threadPool.Run(tasks);
+  } catch (...) {
+    overlapChecks_ += overlapChecks;
+    throw;
+  }
+
+  overlapChecks_ += overlapChecks;
+
+  ThrowIfCancelled();
+
+  return overlappingVertices;
+}
+
+void PluginGraph::AddOverlapEdges(const GameType gameType,
+                                  ThreadPool& threadPool) {
+  auto logger = getLogger();
+  const auto overlappingVertices =
+      FindOverlappingVertices(gameType, threadPool);
+
+  // Add the edges serially and in vertex order, so that which edges are
+  // skipped for creating cycles doesn't depend on thread scheduling.
   vertex_it vit, vitend;
-  for (tie(vit, vitend) = boost::vertices(graph_); vit != vitend; ++vit) {
+  for (std::tie(vit, vitend) = PluginVertices(); vit != vitend; ++vit) {
+    ThrowIfCancelled();
+
     vertex_t vertex = *vit;
 
     if (graph_[vertex].NumOverrideFormIDs() == 0) {
@@ -688,15 +932,8 @@ void PluginGraph::AddOverlapEdges() {
       continue;
     }
 
-    for (vertex_it vit2 = std::next(vit); vit2 != vitend; ++vit2) {
-      vertex_t otherVertex = *vit2;
-
-      if (vertex == otherVertex ||
-          boost::edge(vertex, otherVertex, graph_).second ||
-          boost::edge(otherVertex, vertex, graph_).second ||
-          graph_[vertex].NumOverrideFormIDs() ==
-              graph_[otherVertex].NumOverrideFormIDs() ||
-          !graph_[vertex].DoFormIDsOverlap(graph_[otherVertex])) {
+    for (const auto& otherVertex : overlappingVertices[vertex]) {
+      if (HasEdge(vertex, otherVertex) || HasEdge(otherVertex, vertex)) {
         continue;
       }
 
@@ -762,9 +999,12 @@ void PluginGraph::AddTieBreakEdges() {
   // In order for the sort to be performed stably, there must be only one
   // possible result. This can be enforced by adding edges between all vertices
   // that aren't already linked. Use existing load order to decide the direction
-  // of these edges.
+  // of these edges. Vertices that are already linked by a path don't need an
+  // edge, as it wouldn't change the order.
   vertex_it vit, vitend;
-  for (tie(vit, vitend) = boost::vertices(graph_); vit != vitend; ++vit) {
+  for (std::tie(vit, vitend) = PluginVertices(); vit != vitend; ++vit) {
+    ThrowIfCancelled();
+
     vertex_t vertex = *vit;
 
     for (vertex_it vit2 = std::next(vit); vit2 != vitend; ++vit2) {
@@ -779,9 +1019,84 @@ void PluginGraph::AddTieBreakEdges() {
         toVertex = vertex;
       }
 
-      if (!EdgeCreatesCycle(fromVertex, toVertex))
+      if (!EdgeCreatesCycle(fromVertex, toVertex) &&
+          !PathExists(fromVertex, toVertex))
         AddEdge(fromVertex, toVertex, EdgeType::tieBreak);
     }
   }
 }
+
+std::vector<std::string> PluginGraph::PriorityTopologicalSort() const {
+  auto logger = getLogger();
+  if (logger) {
+    logger->trace("Performing priority topological sort on plugin graph...");
+  }
+
+  // Rank the vertices using the same comparison as is used to decide the
+  // direction of tie-break edges, so that the priority queue only needs to
+  // compare integers. Group vertices are ranked first so that they're
+  // processed as soon as they're ready, as they don't appear in the output.
+  std::vector<vertex_t> verticesByRank;
+  verticesByRank.reserve(boost::num_vertices(graph_));
+  vertex_it vit, vitend;
+  for (std::tie(vit, vitend) = boost::vertices(graph_); vit != vitend; ++vit) {
+    verticesByRank.push_back(*vit);
+  }
+  std::sort(verticesByRank.begin(),
+            verticesByRank.end(),
+            [&](const vertex_t& lhs, const vertex_t& rhs) {
+              if (lhs >= pluginCount_ || rhs >= pluginCount_) {
+                return lhs >= pluginCount_ && (rhs < pluginCount_ || lhs < rhs);
+              }
+              return ComparePlugins(graph_[lhs], graph_[rhs]) < 0;
+            });
+
+  std::vector<size_t> ranks(verticesByRank.size());
+  for (size_t rank = 0; rank < verticesByRank.size(); ++rank) {
+    ranks[verticesByRank[rank]] = rank;
+  }
+
+  // Kahn's algorithm, always picking the highest-priority (lowest-ranked)
+  // vertex out of those that have no unsorted in-edges.
+  std::priority_queue<size_t, std::vector<size_t>, std::greater<size_t>>
+      readyRanks;
+  std::vector<size_t> inDegrees(verticesByRank.size());
+  for (const auto& vertex : verticesByRank) {
+    inDegrees[vertex] = boost::in_degree(vertex, graph_);
+    if (inDegrees[vertex] == 0) {
+      readyRanks.push(ranks[vertex]);
+    }
+  }
+
+  std::vector<vertex_t> sortedVertices;
+  sortedVertices.reserve(verticesByRank.size());
+  while (!readyRanks.empty()) {
+    const auto vertex = verticesByRank[readyRanks.top()];
+    readyRanks.pop();
+    if (vertex < pluginCount_) {
+      sortedVertices.push_back(vertex);
+    }
+
+    boost::graph_traits<RawPluginGraph>::adjacency_iterator ait, aitend;
+    for (std::tie(ait, aitend) = boost::adjacent_vertices(vertex, graph_);
+         ait != aitend;
+         ++ait) {
+      inDegrees[*ait] -= 1;
+      if (inDegrees[*ait] == 0) {
+        readyRanks.push(ranks[*ait]);
+      }
+    }
+  }
+
+  return GetPluginNames(sortedVertices);
+}
+
+void PluginGraph::RecordStatistics(SortStatistics& statistics) const {
+  statistics.edges_added = edgesAdded_;
+  statistics.cycle_checks = cycleChecks_;
+  statistics.cyclic_edges_skipped = cyclicEdgesSkipped_;
+  statistics.overlap_checks = overlapChecks_;
+  statistics.vertex_count = boost::num_vertices(graph_);
+  statistics.edge_count = boost::num_edges(graph_);
+}
 }
@@ -28,58 +28,43 @@
 #define FMT_NO_FMT_STRING_ALIAS
 
 #include <map>
+#include <unordered_map>
 
 #include <spdlog/spdlog.h>
-#include <boost/container_hash/hash.hpp>
+#include <boost/dynamic_bitset.hpp>
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/graph_traits.hpp>
 
 #include "api/game/game.h"
+#include "api/helpers/operation_monitor.h"
+#include "api/helpers/thread_pool.h"
 #include "api/plugin.h"
 #include "api/sorting/plugin_sorting_data.h"
 #include "loot/exception/cyclic_interaction_error.h"
+#include "loot/struct/sort_statistics.h"
 
 namespace loot {
-typedef boost::adjacency_list<boost::listS,
-                              boost::listS,
+// Vertices and out-edges are stored in vectors so that vertex descriptors are
+// dense integer indices, which lets per-vertex data be stored in plain arrays
+// instead of maps.
+typedef boost::adjacency_list<boost::vecS,
+                              boost::vecS,
                               boost::bidirectionalS,
                               PluginSortingData,
                               EdgeType>
     RawPluginGraph;
 typedef boost::graph_traits<RawPluginGraph>::vertex_descriptor vertex_t;
-typedef boost::associative_property_map<std::map<vertex_t, size_t>>
-    vertex_map_t;
+typedef boost::graph_traits<RawPluginGraph>::vertex_iterator vertex_it;
 
 std::string describeEdgeType(EdgeType edgeType);
 
-struct GraphPath {
-  GraphPath(vertex_t from, vertex_t to) : from(from), to(to) {}
-
-  bool operator==(const GraphPath& rhs) const {
-    return this->from == rhs.from && this->to == rhs.to;
-  }
-
-  vertex_t from;
-  vertex_t to;
-};
-}
-
-namespace std {
-template<>
-struct hash<loot::GraphPath> {
-  size_t operator()(const loot::GraphPath& graphPath) const {
-    size_t seed = 0;
-    boost::hash_combine(seed, graphPath.from);
-    boost::hash_combine(seed, graphPath.to);
-
-    return seed;
-  }
-};
-}
-
-namespace loot {
 class PluginGraph {
 public:
+  PluginGraph();
+  // The graph's slower stages periodically check if the monitored operation
+  // has been cancelled, and throw an OperationCancelledError if so.
+  explicit PluginGraph(const OperationMonitor& monitor);
+
   size_t CountVertices() const;
   void CheckForCycles() const;
   
@@ -87,21 +72,74 @@ public:
   void AddSpecificEdges();
   void AddHardcodedPluginEdges(Game& game);
   void AddGroupEdges(const std::unordered_set<Group>& groups);
-  void AddOverlapEdges();
+  void AddOverlapEdges(const GameType gameType, ThreadPool& threadPool);
   void AddTieBreakEdges();
 
   std::vector<std::string> TopologicalSort() const;
+  std::vector<std::string> PriorityTopologicalSort() const;
+
+  void RecordStatistics(SortStatistics& statistics) const;
 
 private:
+  void ThrowIfCancelled() const;
   std::optional<vertex_t> GetVertexByName(const std::string& name) const;
-  bool EdgeCreatesCycle(const vertex_t& u, const vertex_t& v);
+  std::optional<vertex_t> GetVertexByKey(const FilenameKey& key) const;
+  std::pair<vertex_it, vertex_it> PluginVertices() const;
+  std::string GetVertexName(const vertex_t& vertex) const;
+  std::vector<std::vector<vertex_t>> FindOverlappingVertices(
+      const GameType gameType,
+      ThreadPool& threadPool);
+  std::vector<std::string> GetPluginNames(
+      const std::vector<vertex_t>& sortedVertices) const;
+  bool HasEdge(const vertex_t& fromVertex, const vertex_t& toVertex) const;
+  bool PathExists(const vertex_t& fromVertex, const vertex_t& toVertex) const;
+  bool EdgeCreatesCycle(const vertex_t& fromVertex, const vertex_t& toVertex);
 
   void AddEdge(const vertex_t& fromVertex,
                const vertex_t& toVertex,
                EdgeType edgeType);
 
+  struct GroupVertices {
+    vertex_t start;
+    vertex_t end;
+  };
+
   RawPluginGraph graph_;
-  std::unordered_set<GraphPath> pathsCache_;
+
+  // Plugins are the first pluginCount_ vertices. They are followed by a start
+  // and an end vertex for each group, which stand in for group edges between
+  // plugins: each plugin has an edge to its group's end vertex, each group's
+  // start vertex has an edge to each of the group's plugins, and the end
+  // vertices of a group's after groups have edges to its start and end
+  // vertices. This needs O(plugins + group edges) edges instead of one edge
+  // for every pair of plugins in groups that load after one another.
+  size_t pluginCount_;
+  std::unordered_map<std::string, GroupVertices> groupVertices_;
+  std::vector<std::string> groupVertexNames_;
+  std::unordered_map<std::string, std::unordered_set<std::string>>
+      transitiveAfterGroups_;
+
+  // Vertices keyed by their normalised plugin filenames, so that looking up
+  // a vertex by name doesn't need to compare it against every vertex.
+  std::unordered_map<FilenameKey, vertex_t> verticesByName_;
+
+  // Each vertex's row has a bit set for every vertex it has an out-edge to, so
+  // that checking if an edge exists doesn't need to walk the edge list.
+  std::vector<boost::dynamic_bitset<>> outEdges_;
+
+  // Reachability index. Each vertex's row in descendants_ has a bit set for
+  // every vertex that can be reached from it, and its row in ancestors_ has a
+  // bit set for every vertex it can be reached from. Both are kept up to date
+  // by AddEdge(), so path queries are a single bit test. With outEdges_, that's
+  // three V x V bitsets, where V counts group vertices as well as plugins.
+  std::vector<boost::dynamic_bitset<>> descendants_;
+  std::vector<boost::dynamic_bitset<>> ancestors_;
+
+  const OperationMonitor* monitor_;
+  std::map<EdgeType, size_t> edgesAdded_;
+  size_t cycleChecks_;
+  size_t cyclicEdgesSkipped_;
+  size_t overlapChecks_;
 };
 }
 
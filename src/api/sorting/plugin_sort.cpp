@@ -24,21 +24,57 @@
 
 #include "plugin_sort.h"
 
+#include <chrono>
+
 #include "api/helpers/logging.h"
 #include "api/sorting/plugin_graph.h"
 
 namespace loot {
+template<typename Function>
+void TimeStage(OperationMonitor& monitor,
+               OperationPhase phase,
+               std::chrono::microseconds& duration,
+               Function function) {
+  monitor.ThrowIfCancelled();
+  monitor.StartPhase(phase);
+
+  const auto start = std::chrono::steady_clock::now();
+  function();
+  duration = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+}
+
 std::vector<std::string> SortPlugins(
     Game& game,
     const std::vector<std::string>& loadOrder) {
-  PluginGraph graph;
+  SortStatistics statistics;
+  return SortPlugins(game, loadOrder, statistics);
+}
+
+std::vector<std::string> SortPlugins(Game& game,
+                                     const std::vector<std::string>& loadOrder,
+                                     SortStatistics& statistics) {
+  OperationMonitor monitor;
+  return SortPlugins(game, loadOrder, statistics, monitor);
+}
 
-  graph.AddPluginVertices(game, loadOrder);
+std::vector<std::string> SortPlugins(Game& game,
+                                     const std::vector<std::string>& loadOrder,
+                                     SortStatistics& statistics,
+                                     OperationMonitor& monitor) {
+  PluginGraph graph(monitor);
+
+  TimeStage(monitor,
+            OperationPhase::add_vertices,
+            statistics.add_vertices_duration,
+            [&]() { graph.AddPluginVertices(game, loadOrder); });
 
   // If there aren't any vertices, exit early, because sorting assumes
   // there is at least one plugin.
-  if (graph.CountVertices() == 0)
+  if (graph.CountVertices() == 0) {
+    graph.RecordStatistics(statistics);
     return std::vector<std::string>();
+  }
 
   auto logger = getLogger();
   if (logger) {
@@ -49,14 +85,57 @@ std::vector<std::string> SortPlugins(
   }
 
   // Now add the interactions between plugins to the graph as edges.
-  graph.AddSpecificEdges();
-  graph.AddHardcodedPluginEdges(game);
-  graph.AddGroupEdges(game.GetDatabase()->GetGroups());
-  graph.AddOverlapEdges();
-  graph.AddTieBreakEdges();
+  TimeStage(monitor,
+            OperationPhase::add_specific_edges,
+            statistics.add_specific_edges_duration,
+            [&]() { graph.AddSpecificEdges(); });
+  TimeStage(monitor,
+            OperationPhase::add_hardcoded_edges,
+            statistics.add_hardcoded_edges_duration,
+            [&]() { graph.AddHardcodedPluginEdges(game); });
+  TimeStage(monitor,
+            OperationPhase::add_group_edges,
+            statistics.add_group_edges_duration,
+            [&]() { graph.AddGroupEdges(game.GetDatabase()->GetGroups()); });
+  TimeStage(monitor,
+            OperationPhase::add_overlap_edges,
+            statistics.add_overlap_edges_duration,
+            [&]() {
+              graph.AddOverlapEdges(game.Type(), *game.GetThreadPool());
+            });
+
+  // The priority engine breaks ties while sorting, so doesn't need
+  // tie-break edges.
+  const bool usePriorityEngine =
+      game.GetSortingEngine() == SortingEngine::priority;
+  if (!usePriorityEngine) {
+    TimeStage(monitor,
+              OperationPhase::add_tie_break_edges,
+              statistics.add_tie_break_edges_duration,
+              [&]() { graph.AddTieBreakEdges(); });
+  }
+
+  // No more edges are added after this point, so record the graph's counters
+  // now in case checking for cycles throws.
+  graph.RecordStatistics(statistics);
+
+  TimeStage(monitor,
+            OperationPhase::check_for_cycles,
+            statistics.check_for_cycles_duration,
+            [&]() { graph.CheckForCycles(); });
 
-  graph.CheckForCycles();
+  std::vector<std::string> sortedPlugins;
+  TimeStage(monitor,
+            OperationPhase::topological_sort,
+            statistics.topological_sort_duration,
+            [&]() {
+              if (usePriorityEngine) {
+                sortedPlugins = graph.PriorityTopologicalSort();
+              } else {
+                sortedPlugins = graph.TopologicalSort();
+              }
+            });
 
-  return graph.TopologicalSort();
+  return sortedPlugins;
 }
 }
@@ -29,10 +29,25 @@
 #include <vector>
 
 #include "api/game/game.h"
+#include "api/helpers/operation_monitor.h"
 
 namespace loot {
 std::vector<std::string> SortPlugins(Game& game,
                                      const std::vector<std::string>& loadOrder);
+
+// Records the time taken by each sorting stage and counters from the plugin
+// graph in the given statistics object.
+std::vector<std::string> SortPlugins(Game& game,
+                                     const std::vector<std::string>& loadOrder,
+                                     SortStatistics& statistics);
+
+// Also reports the start of each sorting stage to the given monitor, and
+// stops with an OperationCancelledError if the monitored operation is
+// cancelled.
+std::vector<std::string> SortPlugins(Game& game,
+                                     const std::vector<std::string>& loadOrder,
+                                     SortStatistics& statistics,
+                                     OperationMonitor& monitor);
 }
 
 #endif
@@ -0,0 +1,193 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "plugin_sort_cache.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "api/helpers/logging.h"
+#include "loot/loot_version.h"
+
+namespace loot {
+// 64-bit FNV-1a, which unlike std::hash gives the same result across
+// processes and platforms.
+std::string GetFnv1aHash(const std::string& data) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (const auto& character : data) {
+    hash ^= (unsigned char)character;
+    hash *= 1099511628211ULL;
+  }
+
+  std::ostringstream stream;
+  stream << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return stream.str();
+}
+
+void AppendGroups(std::ostringstream& stream,
+                  const std::unordered_set<Group>& groups) {
+  // Groups are stored in an unordered set, so sort them to get a consistent
+  // order.
+  std::vector<std::string> groupLines;
+  for (const auto& group : groups) {
+    std::vector<std::string> afterGroups(group.GetAfterGroups().begin(),
+                                         group.GetAfterGroups().end());
+    std::sort(afterGroups.begin(), afterGroups.end());
+
+    std::string line = group.GetName() + ":";
+    for (const auto& afterGroup : afterGroups) {
+      line += afterGroup + ",";
+    }
+    groupLines.push_back(line);
+  }
+  std::sort(groupLines.begin(), groupLines.end());
+
+  for (const auto& line : groupLines) {
+    stream << line << '\n';
+  }
+}
+
+void AppendSortingMetadata(std::ostringstream& stream,
+                           const PluginMetadata& metadata) {
+  stream << metadata.GetGroup().value_or("") << '\n';
+  for (const auto& file : metadata.GetLoadAfterFiles()) {
+    stream << file.GetName() << ',';
+  }
+  stream << '\n';
+  for (const auto& file : metadata.GetRequirements()) {
+    stream << file.GetName() << ',';
+  }
+  stream << '\n';
+}
+
+std::string GetSortFingerprint(Game& game,
+                               const std::vector<std::string>& loadOrder) {
+  std::ostringstream stream;
+
+  stream << LootVersion::GetVersionString() << '\n'
+         << (int)game.Type() << '\n'
+         << game.DataPath().u8string() << '\n'
+         << (int)game.GetSortingEngine() << '\n';
+
+  for (const auto& plugin : loadOrder) {
+    stream << plugin << '\n';
+  }
+
+  for (const auto& plugin :
+       game.GetLoadOrderHandler()->GetImplicitlyActivePlugins()) {
+    stream << plugin << '\n';
+  }
+
+  // Sorting uses evaluated metadata, so hashing that covers the content of
+  // the masterlist and userlist, any unsaved changes to user metadata, and
+  // the state that metadata conditions were evaluated against.
+  auto database = game.GetDatabase();
+  AppendGroups(stream, database->GetGroups(false));
+  AppendGroups(stream, database->GetUserGroups());
+
+  auto dataDirectory = game.GetDataDirectorySnapshot();
+  auto snapshot = game.GetCache()->GetPluginsSnapshot();
+  for (const auto& plugin : snapshot->plugins) {
+    auto file = dataDirectory->FindPlugin(plugin->GetName());
+    std::optional<PluginFileKey> fileKey;
+    if (file.has_value()) {
+      fileKey = file.value().key;
+    }
+
+    stream << plugin->GetName() << '\n'
+           << plugin->GetCRC().value_or(0) << '\n';
+    if (fileKey.has_value()) {
+      stream << fileKey.value().size << '\n'
+             << fileKey.value().modificationTime << '\n';
+    } else {
+      stream << "missing\n";
+    }
+
+    auto masterlistMetadata =
+        database->GetPluginMetadata(plugin->GetName(), false, true)
+            .value_or(PluginMetadata(plugin->GetName()));
+    auto userMetadata = database->GetPluginUserMetadata(plugin->GetName(), true)
+                            .value_or(PluginMetadata(plugin->GetName()));
+
+    AppendSortingMetadata(stream, masterlistMetadata);
+    AppendSortingMetadata(stream, userMetadata);
+  }
+
+  return GetFnv1aHash(stream.str());
+}
+
+std::optional<std::vector<std::string>> ReadCachedSortResult(
+    const std::filesystem::path& cachePath,
+    const std::string& fingerprint) {
+  std::ifstream in(cachePath);
+  if (!in.good()) {
+    return std::nullopt;
+  }
+
+  std::string line;
+  if (!std::getline(in, line) || line != fingerprint) {
+    return std::nullopt;
+  }
+
+  std::vector<std::string> sortedPlugins;
+  while (std::getline(in, line)) {
+    sortedPlugins.push_back(line);
+  }
+
+  return sortedPlugins;
+}
+
+void WriteCachedSortResult(const std::filesystem::path& cachePath,
+                           const std::string& fingerprint,
+                           const std::vector<std::string>& sortedPlugins) {
+  // Write to a temporary file first so that an interrupted write can't
+  // leave a cache file that has a valid fingerprint but a partial result.
+  auto tempPath = cachePath;
+  tempPath += ".tmp";
+
+  std::ofstream out(tempPath);
+  out << fingerprint << '\n';
+  for (const auto& plugin : sortedPlugins) {
+    out << plugin << '\n';
+  }
+  out.close();
+
+  std::error_code errorCode;
+  if (out.good()) {
+    std::filesystem::rename(tempPath, cachePath, errorCode);
+  }
+
+  if (!out.good() || errorCode) {
+    auto logger = getLogger();
+    if (logger) {
+      logger->warn("Failed to write the sort cache file at \"{}\"",
+                   cachePath.u8string());
+    }
+    std::filesystem::remove(tempPath, errorCode);
+  }
+}
+}
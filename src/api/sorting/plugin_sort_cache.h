@@ -0,0 +1,54 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_API_SORTING_PLUGIN_SORT_CACHE
+#define LOOT_API_SORTING_PLUGIN_SORT_CACHE
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "api/game/game.h"
+
+namespace loot {
+// Get a fingerprint of everything that sorting the given load order depends
+// on. The game's plugins must already have been loaded.
+std::string GetSortFingerprint(Game& game,
+                               const std::vector<std::string>& loadOrder);
+
+// Returns the sorted load order stored in the given cache file, if the file
+// exists and was written for the given fingerprint.
+std::optional<std::vector<std::string>> ReadCachedSortResult(
+    const std::filesystem::path& cachePath,
+    const std::string& fingerprint);
+
+// Store the given sorted load order and the fingerprint of the inputs that
+// produced it in the given cache file, replacing any existing content.
+void WriteCachedSortResult(const std::filesystem::path& cachePath,
+                           const std::string& fingerprint,
+                           const std::vector<std::string>& sortedPlugins);
+}
+
+#endif
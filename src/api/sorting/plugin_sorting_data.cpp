@@ -27,17 +27,33 @@
 #include <boost/algorithm/string.hpp>
 
 #include <loot/metadata/group.h>
-#include "api/helpers/text.h"
 
 namespace loot {
+LoadOrderIndexes GetLoadOrderIndexes(
+    const std::vector<std::string>& loadOrder) {
+  LoadOrderIndexes indexes;
+  indexes.reserve(loadOrder.size());
+
+  // If a plugin is listed more than once, its last position wins. Plugins
+  // without keys can't have been loaded, so they don't need indexes.
+  for (size_t i = 0; i < loadOrder.size(); i++) {
+    auto key = FilenameKey::Find(loadOrder[i]);
+    if (key.has_value()) {
+      indexes[key.value()] = i;
+    }
+  }
+
+  return indexes;
+}
+
 std::vector<std::shared_ptr<const Plugin>> GetPluginsSubset(
     const std::set<std::shared_ptr<const Plugin>>& plugins,
-    const std::vector<std::string>& pluginNames) {
+    const std::vector<FilenameKey>& pluginKeys) {
   std::vector<std::shared_ptr<const Plugin>> pluginsSubset;
 
-  for (const auto& pluginName : pluginNames) {
+  for (const auto& pluginKey : pluginKeys) {
     auto pos = std::find_if(plugins.begin(), plugins.end(), [&](auto plugin) {
-      return CompareFilenames(plugin->GetName(), pluginName) == 0;
+      return plugin->GetFilenameKey() == pluginKey;
     });
 
     if (pos != plugins.end()) {
@@ -52,10 +68,13 @@ PluginSortingData::PluginSortingData(
     const Plugin& plugin,
     const PluginMetadata& masterlistMetadata,
     const PluginMetadata& userMetadata,
-    const std::vector<std::string>& loadOrder,
+    const LoadOrderIndexes& loadOrderIndexes,
     const GameType gameType,
     const std::set<std::shared_ptr<const Plugin>>& loadedPlugins) :
-    plugin_(plugin),
+    plugin_(&plugin),
+    isMaster_(plugin.IsMaster() ||
+              (plugin.IsLightMaster() &&
+               !boost::iends_with(plugin.GetName(), ".esp"))),
     masterlistLoadAfter_(masterlistMetadata.GetLoadAfterFiles()),
     userLoadAfter_(userMetadata.GetLoadAfterFiles()),
     masterlistReq_(masterlistMetadata.GetRequirements()),
@@ -68,18 +87,18 @@ PluginSortingData::PluginSortingData(
     group_ = Group().GetName();
   }
 
-  for (size_t i = 0; i < loadOrder.size(); i++) {
-    if (CompareFilenames(plugin.GetName(), loadOrder[i]) == 0) {
-      loadOrderIndex_ = i;
-    }
+  auto it = loadOrderIndexes.find(plugin.GetFilenameKey());
+  if (it != loadOrderIndexes.end()) {
+    loadOrderIndex_ = it->second;
   }
 
   if (gameType == GameType::tes3) {
-    auto masterNames = plugin.GetMasters();
+    const auto& masterNames = plugin.GetHeader().masters;
     if (masterNames.empty()) {
       numOverrideFormIDs = 0;
     } else {
-      auto masters = GetPluginsSubset(loadedPlugins, masterNames);
+      auto masters =
+          GetPluginsSubset(loadedPlugins, plugin.GetHeader().masterKeys);
       if (masters.size() == masterNames.size()) {
         numOverrideFormIDs = plugin.GetOverlapSize(masters);
       } else {
@@ -100,17 +119,27 @@ PluginSortingData::PluginSortingData(
   }
 }
 
-std::string PluginSortingData::GetName() const { return plugin_.GetName(); }
+PluginSortingData::PluginSortingData() :
+    plugin_(nullptr), isMaster_(false), numOverrideFormIDs(0) {}
 
-bool PluginSortingData::IsMaster() const {
-  return plugin_.IsMaster() || (plugin_.IsLightMaster() &&
-                                !boost::iends_with(plugin_.GetName(), ".esp"));
+std::string PluginSortingData::GetName() const { return plugin_->GetName(); }
+
+const FilenameKey& PluginSortingData::GetFilenameKey() const {
+  return plugin_->GetFilenameKey();
 }
 
-bool PluginSortingData::LoadsArchive() const { return plugin_.LoadsArchive(); }
+bool PluginSortingData::IsMaster() const { return isMaster_; }
+
+bool PluginSortingData::LoadsArchive() const {
+  return plugin_->LoadsArchive();
+}
+
+const std::vector<std::string>& PluginSortingData::GetMasters() const {
+  return plugin_->GetHeader().masters;
+}
 
-std::vector<std::string> PluginSortingData::GetMasters() const {
-  return plugin_.GetMasters();
+const std::vector<FilenameKey>& PluginSortingData::GetMasterKeys() const {
+  return plugin_->GetHeader().masterKeys;
 }
 
 size_t PluginSortingData::NumOverrideFormIDs() const {
@@ -119,21 +148,11 @@ size_t PluginSortingData::NumOverrideFormIDs() const {
 
 bool PluginSortingData::DoFormIDsOverlap(
     const PluginSortingData& plugin) const {
-  return plugin_.DoFormIDsOverlap(plugin.plugin_);
+  return plugin_->DoFormIDsOverlap(*plugin.plugin_);
 }
 
 std::string PluginSortingData::GetGroup() const { return group_; }
 
-std::unordered_set<std::string> PluginSortingData::GetAfterGroupPlugins()
-    const {
-  return afterGroupPlugins_;
-}
-
-void PluginSortingData::SetAfterGroupPlugins(
-    std::unordered_set<std::string> plugins) {
-  afterGroupPlugins_ = plugins;
-}
-
 const std::set<File>& PluginSortingData::GetMasterlistLoadAfterFiles() const {
   return masterlistLoadAfter_;
 }
@@ -25,31 +25,42 @@
 #ifndef LOOT_API_SORTING_PLUGIN_SORTING_DATA
 #define LOOT_API_SORTING_PLUGIN_SORTING_DATA
 
+#include <unordered_map>
+
+#include "api/helpers/filename_key.h"
 #include "api/plugin.h"
 #include "loot/metadata/plugin_metadata.h"
 
 namespace loot {
+// Maps each plugin's filename key to its position in the load order.
+typedef std::unordered_map<FilenameKey, size_t> LoadOrderIndexes;
+
+LoadOrderIndexes GetLoadOrderIndexes(const std::vector<std::string>& loadOrder);
+
 class PluginSortingData {
 public:
+  // Boost.Graph's vector-based vertex storage requires vertex properties to be
+  // default-constructible. A default-constructed object has no plugin, and is
+  // only used for vertices that represent groups.
+  PluginSortingData();
   explicit PluginSortingData(const Plugin& plugin,
                     const PluginMetadata& masterlistMetadata,
                     const PluginMetadata& userMetadata,
-                    const std::vector<std::string>& loadOrder,
+                    const LoadOrderIndexes& loadOrderIndexes,
                     const GameType gameType,
                     const std::set<std::shared_ptr<const Plugin>>& loadedPlugins);
 
   std::string GetName() const;
+  const FilenameKey& GetFilenameKey() const;
   bool IsMaster() const;
   bool LoadsArchive() const;
-  std::vector<std::string> GetMasters() const;
+  const std::vector<std::string>& GetMasters() const;
+  const std::vector<FilenameKey>& GetMasterKeys() const;
   size_t NumOverrideFormIDs() const;
   bool DoFormIDsOverlap(const PluginSortingData& plugin) const;
 
   std::string GetGroup() const;
 
-  std::unordered_set<std::string> GetAfterGroupPlugins() const;
-  void SetAfterGroupPlugins(std::unordered_set<std::string> plugins);
-
   const std::set<File>& GetMasterlistLoadAfterFiles() const;
   const std::set<File>& GetUserLoadAfterFiles() const;
   const std::set<File>& GetMasterlistRequirements() const;
@@ -58,9 +69,9 @@ public:
   const std::optional<size_t>& GetLoadOrderIndex() const;
 
 private:
-  const Plugin& plugin_;
+  const Plugin* plugin_;
   std::string group_;
-  std::unordered_set<std::string> afterGroupPlugins_;
+  bool isMaster_;
 
   std::set<File> masterlistLoadAfter_;
   std::set<File> userLoadAfter_;
@@ -0,0 +1,101 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2014-2016    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_BENCHMARKS_GAME_LOAD_PLUGINS_BENCHMARK
+#define LOOT_BENCHMARKS_GAME_LOAD_PLUGINS_BENCHMARK
+
+#include <chrono>
+#include <memory>
+
+#include "api/game/game.h"
+#include "benchmarks/synthetic_game.h"
+
+namespace loot {
+namespace benchmarks {
+static void LoadPluginsBenchmark(::benchmark::State& state,
+                                 bool loadHeadersOnly,
+                                 bool validateWhileParsing) {
+  const auto& syntheticGame = GetSyntheticGame(state);
+
+  std::unique_ptr<Game> game;
+  for (auto _ : state) {
+    // Use a new game for each iteration so that no loaded data is reused,
+    // and replace the previous game outside of the timed section.
+    state.PauseTiming();
+    game = std::make_unique<Game>(SyntheticGame::gameType,
+                                  syntheticGame.GamePath(),
+                                  syntheticGame.LocalPath());
+    state.ResumeTiming();
+
+    if (validateWhileParsing) {
+      ::benchmark::DoNotOptimize(
+          game->TryLoadPlugins(syntheticGame.Plugins(), loadHeadersOnly));
+    } else {
+      game->LoadPlugins(syntheticGame.Plugins(), loadHeadersOnly);
+    }
+  }
+
+  state.counters["plugins/s"] = ::benchmark::Counter(
+      static_cast<double>(syntheticGame.Plugins().size()),
+      ::benchmark::Counter::kIsIterationInvariantRate);
+}
+
+// Reload all plugins after one of them has been modified, as happens when
+// sorting again after editing a plugin.
+static void IncrementalLoadPluginsBenchmark(::benchmark::State& state) {
+  const auto& syntheticGame = GetSyntheticGame(state);
+
+  Game game(SyntheticGame::gameType,
+            syntheticGame.GamePath(),
+            syntheticGame.LocalPath());
+  game.SetIncrementalPluginLoading(true);
+  game.LoadPlugins(syntheticGame.Plugins(), false);
+
+  const auto modifiedPath =
+      syntheticGame.GamePath() / "Data" / syntheticGame.Plugins().back();
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::filesystem::last_write_time(
+        modifiedPath,
+        std::filesystem::last_write_time(modifiedPath) +
+            std::chrono::seconds(1));
+    state.ResumeTiming();
+
+    game.LoadPlugins(syntheticGame.Plugins(), false);
+  }
+}
+
+BENCHMARK(IncrementalLoadPluginsBenchmark)->Apply(SyntheticGameArguments);
+BENCHMARK_CAPTURE(LoadPluginsBenchmark, headersOnly, true, false)
+    ->Apply(SyntheticGameArguments);
+BENCHMARK_CAPTURE(LoadPluginsBenchmark, full, false, false)
+    ->Apply(SyntheticGameArguments);
+BENCHMARK_CAPTURE(LoadPluginsBenchmark, tryHeadersOnly, true, true)
+    ->Apply(SyntheticGameArguments);
+BENCHMARK_CAPTURE(LoadPluginsBenchmark, tryFull, false, true)
+    ->Apply(SyntheticGameArguments);
+}
+}
+
+#endif
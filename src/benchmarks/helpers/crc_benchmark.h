@@ -0,0 +1,168 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2014-2016    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_BENCHMARKS_HELPERS_CRC_BENCHMARK
+#define LOOT_BENCHMARKS_HELPERS_CRC_BENCHMARK
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <boost/crc.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/uuid/uuid_generators.hpp>
+#include <boost/uuid/uuid_io.hpp>
+
+#include "api/helpers/crc.h"
+
+namespace loot {
+namespace benchmarks {
+inline std::vector<char> GetRandomBytes(size_t size) {
+  std::mt19937 generator(size);
+  std::vector<char> bytes(size);
+  for (auto& byte : bytes) {
+    byte = static_cast<char>(generator());
+  }
+
+  return bytes;
+}
+
+// The CRC implementation that GetCrc32() used before it was accelerated: 8 KB
+// reads through an ifstream into Boost's bytewise CRC.
+inline uint32_t GetBaselineCrc32(const std::filesystem::path& filename) {
+  std::ifstream ifile(filename, std::ios::binary);
+  ifile.exceptions(std::ios_base::badbit | std::ios_base::failbit);
+
+  ifile.seekg(0, std::ios_base::end);
+  size_t bytesLeft = ifile.tellg();
+  ifile.seekg(0, std::ios_base::beg);
+
+  static const size_t bufferSize = 8192;
+  char buffer[bufferSize];
+  boost::crc_32_type result;
+  while (bytesLeft > 0) {
+    ifile.read(buffer, std::min(bytesLeft, bufferSize));
+    result.process_bytes(buffer, ifile.gcount());
+    bytesLeft -= ifile.gcount();
+  }
+
+  return result.checksum();
+}
+
+static void Crc32BufferBoost(::benchmark::State& state) {
+  const auto bytes = GetRandomBytes(state.range(0));
+
+  for (auto _ : state) {
+    boost::crc_32_type result;
+    result.process_bytes(bytes.data(), bytes.size());
+    ::benchmark::DoNotOptimize(result.checksum());
+  }
+
+  state.SetBytesProcessed(state.iterations() * bytes.size());
+}
+
+static void Crc32BufferPortable(::benchmark::State& state) {
+  const auto bytes = GetRandomBytes(state.range(0));
+
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(
+        UpdateCrc32Portable(0, bytes.data(), bytes.size()));
+  }
+
+  state.SetBytesProcessed(state.iterations() * bytes.size());
+}
+
+static void Crc32Buffer(::benchmark::State& state) {
+  const auto bytes = GetRandomBytes(state.range(0));
+
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(UpdateCrc32(0, bytes.data(), bytes.size()));
+  }
+
+  state.SetBytesProcessed(state.iterations() * bytes.size());
+  state.SetLabel(IsCrc32HardwareAccelerated() ? "pclmul" : "portable");
+}
+
+BENCHMARK(Crc32BufferBoost)->RangeMultiplier(64)->Range(64, 16 << 20);
+BENCHMARK(Crc32BufferPortable)->RangeMultiplier(64)->Range(64, 16 << 20);
+BENCHMARK(Crc32Buffer)->RangeMultiplier(64)->Range(64, 16 << 20);
+
+// Writes a file of random bytes for the file benchmarks, which is deleted
+// when the benchmark finishes. The file will usually be in the page cache, so
+// these benchmarks measure the cost of reading and checksumming rather than
+// disk throughput.
+class RandomFile {
+public:
+  explicit RandomFile(size_t size) :
+      path_(std::filesystem::temp_directory_path() /
+            ("libloot-benchmark-" +
+             boost::lexical_cast<std::string>(
+                 (boost::uuids::random_generator())()) +
+             ".bin")) {
+    const auto bytes = GetRandomBytes(size);
+    std::ofstream out(path_, std::ios::binary);
+    out.write(bytes.data(), bytes.size());
+  }
+
+  ~RandomFile() {
+    std::error_code errorCode;
+    std::filesystem::remove(path_, errorCode);
+  }
+
+  const std::filesystem::path& Path() const { return path_; }
+
+private:
+  const std::filesystem::path path_;
+};
+
+static void Crc32FileBaseline(::benchmark::State& state) {
+  RandomFile file(state.range(0));
+
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(GetBaselineCrc32(file.Path()));
+  }
+
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+static void Crc32File(::benchmark::State& state) {
+  RandomFile file(state.range(0));
+
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(GetCrc32(file.Path()));
+  }
+
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(Crc32FileBaseline)->RangeMultiplier(16)->Range(64 << 10, 256 << 20);
+BENCHMARK(Crc32File)->RangeMultiplier(16)->Range(64 << 10, 256 << 20);
+}
+}
+
+#endif
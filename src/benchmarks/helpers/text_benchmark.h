@@ -0,0 +1,234 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2014-2016    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_BENCHMARKS_HELPERS_TEXT_BENCHMARK
+#define LOOT_BENCHMARKS_HELPERS_TEXT_BENCHMARK
+
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <boost/algorithm/string.hpp>
+
+#ifndef _WIN32
+#include <unicode/uchar.h>
+#include <unicode/unistr.h>
+#endif
+
+#include "api/helpers/text.h"
+
+namespace loot {
+namespace benchmarks {
+// Plugin-like filenames of typical lengths, in mixed case. If a suffix is
+// given it's added to every name, e.g. to make them non-ASCII.
+inline std::vector<std::string> GetFilenames(size_t count,
+                                             const std::string& suffix = "") {
+  static const std::vector<std::string> words({
+      "Unofficial", "Skyrim", "Special", "Edition", "Patch", "Immersive",
+      "ARMORS", "weapons", "Landscape", "Fixes", "for", "Grass", "Mods",
+      "Cutting", "Room", "Floor", "AI", "Overhaul", "dawnguard", "Hearthfires",
+  });
+
+  std::mt19937 generator(count);
+  std::uniform_int_distribution<size_t> wordCount(1, 5);
+  std::uniform_int_distribution<size_t> wordIndex(0, words.size() - 1);
+
+  std::vector<std::string> filenames;
+  for (size_t i = 0; i < count; ++i) {
+    std::string filename;
+    for (size_t j = wordCount(generator); j > 0; --j) {
+      filename += words[wordIndex(generator)] + " ";
+    }
+    filenames.push_back(filename + std::to_string(i) + suffix + ".esp");
+  }
+
+  return filenames;
+}
+
+#ifndef _WIN32
+// The implementations that CompareFilenames() and NormalizeFilename() used
+// before they had an ASCII fast path.
+inline int CompareFilenamesBaseline(const std::string& lhs,
+                                    const std::string& rhs) {
+  auto unicodeLhs = icu::UnicodeString::fromUTF8(lhs);
+  auto unicodeRhs = icu::UnicodeString::fromUTF8(rhs);
+  return unicodeLhs.caseCompare(unicodeRhs, U_FOLD_CASE_DEFAULT);
+}
+
+inline std::string NormalizeFilenameBaseline(const std::string& filename) {
+  std::string normalizedFilename;
+  icu::UnicodeString::fromUTF8(filename)
+      .foldCase(U_FOLD_CASE_DEFAULT)
+      .toUTF8String(normalizedFilename);
+  return normalizedFilename;
+}
+#endif
+
+// Compare each filename with the next, as happens when they're inserted into
+// a sorted container.
+template<typename Compare>
+void CompareAdjacentFilenames(::benchmark::State& state,
+                              const std::vector<std::string>& filenames,
+                              Compare compare) {
+  for (auto _ : state) {
+    for (size_t i = 1; i < filenames.size(); ++i) {
+      ::benchmark::DoNotOptimize(compare(filenames[i - 1], filenames[i]));
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * (filenames.size() - 1));
+}
+
+template<typename Normalize>
+void NormalizeEachFilename(::benchmark::State& state,
+                           const std::vector<std::string>& filenames,
+                           Normalize normalize) {
+  for (auto _ : state) {
+    for (const auto& filename : filenames) {
+      ::benchmark::DoNotOptimize(normalize(filename));
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * filenames.size());
+}
+
+static void CompareFilenamesAscii(::benchmark::State& state) {
+  CompareAdjacentFilenames(state, GetFilenames(1000), CompareFilenames);
+}
+
+// \u00e9 is 'é', which sends the filenames down the Unicode path.
+static void CompareFilenamesNonAscii(::benchmark::State& state) {
+  CompareAdjacentFilenames(
+      state, GetFilenames(1000, u8"\u00e9"), CompareFilenames);
+}
+
+static void NormalizeFilenameAscii(::benchmark::State& state) {
+  NormalizeEachFilename(state, GetFilenames(1000), NormalizeFilename);
+}
+
+static void NormalizeFilenameNonAscii(::benchmark::State& state) {
+  NormalizeEachFilename(
+      state, GetFilenames(1000, u8"\u00e9"), NormalizeFilename);
+}
+
+BENCHMARK(CompareFilenamesAscii);
+BENCHMARK(CompareFilenamesNonAscii);
+BENCHMARK(NormalizeFilenameAscii);
+BENCHMARK(NormalizeFilenameNonAscii);
+
+#ifndef _WIN32
+static void CompareFilenamesAsciiBaseline(::benchmark::State& state) {
+  CompareAdjacentFilenames(state, GetFilenames(1000), CompareFilenamesBaseline);
+}
+
+static void NormalizeFilenameAsciiBaseline(::benchmark::State& state) {
+  NormalizeEachFilename(state, GetFilenames(1000), NormalizeFilenameBaseline);
+}
+
+BENCHMARK(CompareFilenamesAsciiBaseline);
+BENCHMARK(NormalizeFilenameAsciiBaseline);
+#endif
+
+// Plugin descriptions with versions in each of the formats that
+// ExtractVersion() looks for, and one with no version, so that every format
+// gets searched for.
+inline std::vector<std::string> GetDescriptions() {
+  return {
+      "Unofficial Skyrim Special Edition Patch\n\nA comprehensive bugfixing "
+      "mod for The Elder Scrolls V: Skyrim - Special Edition\n\nVersion: "
+      "4.1.4\n\nRequires Skyrim Special Edition 1.5.39 or greater.\n\n"
+      "{{BASH:C.Climate,C.Encounter,C.ImageSpace,C.Light,C.Location,"
+      "C.SkyLighting,Delev,Graphics,Invent,Names,Relev,Sound,Stats}}",
+      "Updated: 10/09/2016 13:15:18\r\n\r\nRecords Changed: 43",
+      "Compatibility patch for AOS v2.5 and True Storms v1.5 (or "
+      "later),\nPatch Version: 1.0",
+      "Immersive Armors v8 Main Plugin",
+      "Adds 8 variants of Triss Merigold's outfit from \"The Witcher 2\"",
+  };
+}
+
+// The implementation that ExtractVersion() used before it scanned for
+// versions by hand.
+inline std::optional<std::string> ExtractVersionBaseline(
+    const std::string& text) {
+  const std::string pseudosemVersionRegex =
+      R"((\d+(?:\.\d+)+(?:[-._:]?[A-Za-z0-9]+)*))"
+      R"((?!,))";
+  static const std::vector<std::regex> versionRegexes({
+      std::regex(R"((\d{1,2}/\d{1,2}/\d{1,4} \d{1,2}:\d{1,2}:\d{1,2}))",
+                 std::regex::ECMAScript | std::regex::icase),
+      std::regex(R"(version:?\s)" + pseudosemVersionRegex,
+                 std::regex::ECMAScript | std::regex::icase),
+      std::regex(R"((?:^|v|\s))" + pseudosemVersionRegex,
+                 std::regex::ECMAScript | std::regex::icase),
+      std::regex(R"((?:^|v|version:\s*)(\d+))",
+                 std::regex::ECMAScript | std::regex::icase),
+  });
+
+  std::smatch what;
+  for (const auto& versionRegex : versionRegexes) {
+    if (std::regex_search(text, what, versionRegex)) {
+      for (auto it = next(begin(what)); it != end(what); ++it) {
+        if (it->str().empty())
+          continue;
+
+        std::string version = *it;
+        boost::trim(version);
+        return version;
+      }
+    }
+  }
+
+  return std::nullopt;
+}
+
+template<typename Extract>
+void ExtractEachVersion(::benchmark::State& state, Extract extract) {
+  const auto descriptions = GetDescriptions();
+
+  for (auto _ : state) {
+    for (const auto& description : descriptions) {
+      ::benchmark::DoNotOptimize(extract(description));
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * descriptions.size());
+}
+
+static void ExtractVersionFromDescriptions(::benchmark::State& state) {
+  ExtractEachVersion(state, ExtractVersion);
+}
+
+static void ExtractVersionFromDescriptionsBaseline(::benchmark::State& state) {
+  ExtractEachVersion(state, ExtractVersionBaseline);
+}
+
+BENCHMARK(ExtractVersionFromDescriptions);
+BENCHMARK(ExtractVersionFromDescriptionsBaseline);
+}
+}
+
+#endif
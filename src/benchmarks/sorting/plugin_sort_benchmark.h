@@ -0,0 +1,179 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2014-2016    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_BENCHMARKS_SORTING_PLUGIN_SORT_BENCHMARK
+#define LOOT_BENCHMARKS_SORTING_PLUGIN_SORT_BENCHMARK
+
+#include <memory>
+
+#include "api/game/game.h"
+#include "api/sorting/plugin_graph.h"
+#include "api/sorting/plugin_sort.h"
+#include "benchmarks/synthetic_game.h"
+
+namespace loot {
+namespace benchmarks {
+// The stages of sorting, in the order they are run.
+enum struct SortStage {
+  addPluginVertices,
+  addSpecificEdges,
+  addHardcodedPluginEdges,
+  addGroupEdges,
+  addOverlapEdges,
+  addTieBreakEdges,
+  checkForCycles,
+  topologicalSort,
+  priorityTopologicalSort,
+};
+
+inline std::unique_ptr<Game> CreateLoadedGame(
+    const SyntheticGame& syntheticGame) {
+  auto game = std::make_unique<Game>(SyntheticGame::gameType,
+                                     syntheticGame.GamePath(),
+                                     syntheticGame.LocalPath());
+  game->LoadCurrentLoadOrderState();
+  game->GetDatabase()->LoadLists(syntheticGame.MasterlistPath());
+  game->LoadPlugins(syntheticGame.Plugins(), false);
+
+  return game;
+}
+
+inline void RunSortStage(PluginGraph& graph, Game& game, SortStage stage) {
+  switch (stage) {
+    case SortStage::addPluginVertices:
+      graph.AddPluginVertices(game, game.GetLoadOrder());
+      break;
+    case SortStage::addSpecificEdges:
+      graph.AddSpecificEdges();
+      break;
+    case SortStage::addHardcodedPluginEdges:
+      graph.AddHardcodedPluginEdges(game);
+      break;
+    case SortStage::addGroupEdges:
+      graph.AddGroupEdges(game.GetDatabase()->GetGroups());
+      break;
+    case SortStage::addOverlapEdges:
+      graph.AddOverlapEdges(game.Type(), *game.GetThreadPool());
+      break;
+    case SortStage::addTieBreakEdges:
+      graph.AddTieBreakEdges();
+      break;
+    case SortStage::checkForCycles:
+      graph.CheckForCycles();
+      break;
+    case SortStage::topologicalSort:
+      ::benchmark::DoNotOptimize(graph.TopologicalSort());
+      break;
+    case SortStage::priorityTopologicalSort:
+      ::benchmark::DoNotOptimize(graph.PriorityTopologicalSort());
+      break;
+  }
+}
+
+// Benchmark one stage of sorting, building the graph up to that stage
+// outside of the timed section. The priority engine's topological sort runs
+// on a graph without tie-break edges, as it does when sorting.
+static void SortStageBenchmark(::benchmark::State& state, SortStage stage) {
+  const auto game = CreateLoadedGame(GetSyntheticGame(state));
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto graph = std::make_unique<PluginGraph>();
+    for (int i = 0; i < static_cast<int>(stage); ++i) {
+      const auto previousStage = static_cast<SortStage>(i);
+      if (previousStage == SortStage::topologicalSort ||
+          (previousStage == SortStage::addTieBreakEdges &&
+           stage == SortStage::priorityTopologicalSort)) {
+        continue;
+      }
+
+      RunSortStage(*graph, *game, previousStage);
+    }
+    state.ResumeTiming();
+
+    RunSortStage(*graph, *game, stage);
+
+    state.PauseTiming();
+    graph.reset();
+    state.ResumeTiming();
+  }
+}
+
+BENCHMARK_CAPTURE(SortStageBenchmark,
+                  AddPluginVertices,
+                  SortStage::addPluginVertices)
+    ->Apply(SyntheticGameArguments);
+BENCHMARK_CAPTURE(SortStageBenchmark,
+                  AddSpecificEdges,
+                  SortStage::addSpecificEdges)
+    ->Apply(SyntheticGameArguments);
+BENCHMARK_CAPTURE(SortStageBenchmark,
+                  AddHardcodedPluginEdges,
+                  SortStage::addHardcodedPluginEdges)
+    ->Apply(SyntheticGameArguments);
+BENCHMARK_CAPTURE(SortStageBenchmark, AddGroupEdges, SortStage::addGroupEdges)
+    ->Apply(SyntheticGameArguments);
+BENCHMARK_CAPTURE(SortStageBenchmark,
+                  AddOverlapEdges,
+                  SortStage::addOverlapEdges)
+    ->Apply(SyntheticGameArguments);
+BENCHMARK_CAPTURE(SortStageBenchmark,
+                  AddTieBreakEdges,
+                  SortStage::addTieBreakEdges)
+    ->Apply(SyntheticGameArguments);
+BENCHMARK_CAPTURE(SortStageBenchmark,
+                  CheckForCycles,
+                  SortStage::checkForCycles)
+    ->Apply(SyntheticGameArguments);
+BENCHMARK_CAPTURE(SortStageBenchmark,
+                  TopologicalSort,
+                  SortStage::topologicalSort)
+    ->Apply(SyntheticGameArguments);
+BENCHMARK_CAPTURE(SortStageBenchmark,
+                  PriorityTopologicalSort,
+                  SortStage::priorityTopologicalSort)
+    ->Apply(SyntheticGameArguments);
+
+// Benchmark the whole of sorting, excluding plugin loading.
+static void SortPluginsBenchmark(::benchmark::State& state,
+                                 SortingEngine engine) {
+  const auto game = CreateLoadedGame(GetSyntheticGame(state));
+  game->SetSortingEngine(engine);
+
+  const auto loadOrder = game->GetLoadOrder();
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(loot::SortPlugins(*game, loadOrder));
+  }
+}
+
+BENCHMARK_CAPTURE(SortPluginsBenchmark,
+                  compatibility,
+                  SortingEngine::compatibility)
+    ->Apply(SyntheticGameArguments);
+BENCHMARK_CAPTURE(SortPluginsBenchmark, priority, SortingEngine::priority)
+    ->Apply(SyntheticGameArguments);
+}
+}
+
+#endif
@@ -0,0 +1,361 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2014-2016    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_BENCHMARKS_SYNTHETIC_GAME
+#define LOOT_BENCHMARKS_SYNTHETIC_GAME
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <boost/lexical_cast.hpp>
+#include <boost/uuid/uuid_generators.hpp>
+#include <boost/uuid/uuid_io.hpp>
+
+#include "loot/enum/game_type.h"
+
+namespace loot {
+namespace benchmarks {
+struct SyntheticGameOptions {
+  size_t pluginCount;
+  size_t mastersPerPlugin;
+  size_t recordsPerPlugin;
+  // The percentage of each plugin's records that override a record from one
+  // of its masters. As overrides are picked at random from a master's records,
+  // higher percentages make overlapping plugins more common.
+  size_t overridePercentage;
+  // Groups are chained so that each loads after the one before it, and the
+  // plugins are divided evenly between them in load order.
+  size_t groupCount;
+};
+
+// Generates an Oblivion install containing valid plugins that have the given
+// shape. The first tenth of the plugins are masters, and every plugin only
+// has masters that load before it. Plugin content is generated from a fixed
+// seed, so the same options always give the same plugins.
+class SyntheticGame {
+public:
+  static constexpr GameType gameType = GameType::tes4;
+
+  explicit SyntheticGame(const SyntheticGameOptions& options) :
+      rootPath_(std::filesystem::absolute(
+          std::filesystem::temp_directory_path() /
+          ("libloot-benchmark-" + boost::lexical_cast<std::string>(
+                                      (boost::uuids::random_generator())())))),
+      gamePath_(rootPath_ / "game"),
+      localPath_(rootPath_ / "local"),
+      masterlistPath_(rootPath_ / "masterlist.yaml") {
+    std::filesystem::create_directories(gamePath_ / "Data");
+    std::filesystem::create_directories(localPath_);
+
+    GeneratePlugins(options);
+    GenerateMasterlist(options);
+  }
+
+  ~SyntheticGame() {
+    std::error_code errorCode;
+    std::filesystem::remove_all(rootPath_, errorCode);
+  }
+
+  SyntheticGame(const SyntheticGame&) = delete;
+  SyntheticGame& operator=(const SyntheticGame&) = delete;
+
+  const std::filesystem::path& GamePath() const { return gamePath_; }
+  const std::filesystem::path& LocalPath() const { return localPath_; }
+  const std::filesystem::path& MasterlistPath() const {
+    return masterlistPath_;
+  }
+
+  // The plugins in their generated load order.
+  const std::vector<std::string>& Plugins() const { return plugins_; }
+
+private:
+  static constexpr uint32_t firstObjectIndex = 0x800;
+
+  static std::string GetPluginName(size_t index, size_t masterCount) {
+    if (index == 0) {
+      return "Oblivion.esm";
+    }
+
+    auto number = std::to_string(index);
+    number.insert(0, 4 - std::min(number.size(), (size_t)4), '0');
+
+    if (index < masterCount) {
+      return "Master" + number + ".esm";
+    }
+
+    return "Plugin" + number + ".esp";
+  }
+
+  static void WriteUInt16(std::string& buffer, uint16_t value) {
+    buffer.push_back(static_cast<char>(value & 0xFF));
+    buffer.push_back(static_cast<char>((value >> 8) & 0xFF));
+  }
+
+  static void WriteUInt32(std::string& buffer, uint32_t value) {
+    WriteUInt16(buffer, static_cast<uint16_t>(value & 0xFFFF));
+    WriteUInt16(buffer, static_cast<uint16_t>(value >> 16));
+  }
+
+  static void WriteSubrecord(std::string& buffer,
+                             const char* type,
+                             const std::string& data) {
+    buffer.append(type, 4);
+    WriteUInt16(buffer, static_cast<uint16_t>(data.size()));
+    buffer.append(data);
+  }
+
+  // Oblivion record headers are 20 bytes long: type, data size, flags, FormID
+  // and version control info.
+  static void WriteRecord(std::string& buffer,
+                          const char* type,
+                          uint32_t flags,
+                          uint32_t formId,
+                          const std::string& data) {
+    buffer.append(type, 4);
+    WriteUInt32(buffer, static_cast<uint32_t>(data.size()));
+    WriteUInt32(buffer, flags);
+    WriteUInt32(buffer, formId);
+    WriteUInt32(buffer, 0);
+    buffer.append(data);
+  }
+
+  static std::string GetPluginData(const std::vector<std::string>& masters,
+                                   bool isMaster,
+                                   const std::vector<uint32_t>& formIds) {
+    std::string header;
+    std::string hedr;
+    // HEDR holds the version as a float, which is 1.0 for Oblivion.
+    WriteUInt32(hedr, 0x3F800000);
+    WriteUInt32(hedr, static_cast<uint32_t>(formIds.size()));
+    WriteUInt32(hedr, firstObjectIndex + static_cast<uint32_t>(formIds.size()));
+    WriteSubrecord(header, "HEDR", hedr);
+
+    for (const auto& master : masters) {
+      WriteSubrecord(header, "MAST", master + '\0');
+      WriteSubrecord(header, "DATA", std::string(8, '\0'));
+    }
+
+    std::string recordData;
+    WriteSubrecord(recordData, "EDID", std::string("Synthetic") + '\0');
+
+    std::string records;
+    for (const auto formId : formIds) {
+      WriteRecord(records, "MISC", 0, formId, recordData);
+    }
+
+    std::string data;
+    WriteRecord(data, "TES4", isMaster ? 1 : 0, 0, header);
+
+    // Group headers are also 20 bytes long, and their size includes the
+    // header.
+    data.append("GRUP", 4);
+    WriteUInt32(data, static_cast<uint32_t>(records.size() + 20));
+    data.append("MISC", 4);
+    WriteUInt32(data, 0);
+    WriteUInt32(data, 0);
+    data.append(records);
+
+    return data;
+  }
+
+  void GeneratePlugins(const SyntheticGameOptions& options) {
+    std::mt19937 generator(static_cast<unsigned int>(
+        options.pluginCount ^ (options.mastersPerPlugin << 8) ^
+        (options.overridePercentage << 16) ^ (options.groupCount << 24)));
+
+    const size_t masterCount = std::max(options.pluginCount / 10, (size_t)1);
+    const size_t overrideCount =
+        options.recordsPerPlugin * options.overridePercentage / 100;
+    const size_t newRecordCount = options.recordsPerPlugin - overrideCount;
+
+    // Each plugin's new records, in the plugin's own FormID space.
+    std::vector<size_t> newRecordCounts;
+
+    // Timestamps decide the load order for Oblivion, so space them out.
+    const auto baseTime = std::filesystem::file_time_type::clock::now() -
+                          std::chrono::hours(24 * 365);
+
+    for (size_t i = 0; i < options.pluginCount; ++i) {
+      // Pick masters at random from the masters that load before this plugin.
+      std::vector<size_t> masterIndices;
+      const size_t availableMasters = std::min(i, masterCount);
+      if (availableMasters > 0) {
+        masterIndices.push_back(0);
+      }
+      for (size_t attempt = 0; masterIndices.size() <
+                                   std::min(options.mastersPerPlugin,
+                                            availableMasters) &&
+                               attempt < options.mastersPerPlugin * 4;
+           ++attempt) {
+        std::uniform_int_distribution<size_t> distribution(
+            0, availableMasters - 1);
+        const auto index = distribution(generator);
+        if (std::find(masterIndices.begin(), masterIndices.end(), index) ==
+            masterIndices.end()) {
+          masterIndices.push_back(index);
+        }
+      }
+      std::sort(masterIndices.begin(), masterIndices.end());
+
+      std::vector<std::string> masters;
+      for (const auto index : masterIndices) {
+        masters.push_back(GetPluginName(index, masterCount));
+      }
+
+      std::vector<uint32_t> formIds;
+      if (!masterIndices.empty()) {
+        for (size_t j = 0; j < overrideCount; ++j) {
+          std::uniform_int_distribution<size_t> masterDistribution(
+              0, masterIndices.size() - 1);
+          const auto masterPosition = masterDistribution(generator);
+          const auto masterIndex = masterIndices[masterPosition];
+          if (newRecordCounts[masterIndex] == 0) {
+            continue;
+          }
+
+          // A master's new records have its own master count as their mod
+          // index, but are referenced in this plugin using the master's
+          // position in this plugin's masters list.
+          std::uniform_int_distribution<size_t> recordDistribution(
+              0, newRecordCounts[masterIndex] - 1);
+          const auto objectIndex =
+              firstObjectIndex +
+              static_cast<uint32_t>(recordDistribution(generator));
+          const auto formId =
+              (static_cast<uint32_t>(masterPosition) << 24) | objectIndex;
+          if (std::find(formIds.begin(), formIds.end(), formId) ==
+              formIds.end()) {
+            formIds.push_back(formId);
+          }
+        }
+      }
+
+      for (size_t j = 0; j < newRecordCount; ++j) {
+        formIds.push_back((static_cast<uint32_t>(masters.size()) << 24) |
+                          (firstObjectIndex + static_cast<uint32_t>(j)));
+      }
+
+      newRecordCounts.push_back(newRecordCount);
+
+      const auto name = GetPluginName(i, masterCount);
+      const auto path = gamePath_ / "Data" / name;
+      std::ofstream out(path, std::ios::binary);
+      out << GetPluginData(masters, i < masterCount, formIds);
+      out.close();
+
+      std::filesystem::last_write_time(path,
+                                       baseTime + std::chrono::minutes(i));
+
+      plugins_.push_back(name);
+    }
+  }
+
+  void GenerateMasterlist(const SyntheticGameOptions& options) {
+    using std::endl;
+
+    std::ofstream masterlist(masterlistPath_);
+    masterlist << "groups:" << endl << "  - name: default" << endl;
+    for (size_t i = 1; i < options.groupCount; ++i) {
+      masterlist << "  - name: group" << i << endl
+                 << "    after:" << endl
+                 << "      - "
+                 << (i == 1 ? "default" : "group" + std::to_string(i - 1))
+                 << endl;
+    }
+
+    masterlist << "plugins:" << endl;
+    for (size_t i = 0; i < plugins_.size(); ++i) {
+      const auto group = i * std::max(options.groupCount, (size_t)1) /
+                         plugins_.size();
+      if (group == 0) {
+        continue;
+      }
+
+      masterlist << "  - name: '" << plugins_[i] << "'" << endl
+                 << "    group: group" << group << endl;
+    }
+  }
+
+  const std::filesystem::path rootPath_;
+  const std::filesystem::path gamePath_;
+  const std::filesystem::path localPath_;
+  const std::filesystem::path masterlistPath_;
+  std::vector<std::string> plugins_;
+};
+
+// Get a synthetic game for the options given by a benchmark's arguments,
+// generating it the first time it is needed. Generated games are reused by
+// all benchmarks that use the same options, and deleted on exit.
+inline const SyntheticGame& GetSyntheticGame(const ::benchmark::State& state) {
+  static std::map<std::vector<int64_t>, std::unique_ptr<SyntheticGame>> games;
+
+  const std::vector<int64_t> key(
+      {state.range(0), state.range(1), state.range(2), state.range(3)});
+  auto it = games.find(key);
+  if (it == games.end()) {
+    SyntheticGameOptions options;
+    options.pluginCount = static_cast<size_t>(state.range(0));
+    options.mastersPerPlugin = static_cast<size_t>(state.range(1));
+    options.recordsPerPlugin = 50;
+    options.overridePercentage = static_cast<size_t>(state.range(2));
+    options.groupCount = static_cast<size_t>(state.range(3));
+
+    it = games.emplace(key, std::make_unique<SyntheticGame>(options)).first;
+  }
+
+  return *it->second;
+}
+
+// Benchmark a range of plugin counts with typical settings, then vary each
+// of the other settings in turn for a mid-sized load order.
+inline void SyntheticGameArguments(
+    ::benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"plugins", "masters", "overrides%", "groups"});
+
+  for (const int64_t pluginCount : {100, 1000, 5000}) {
+    benchmark->Args({pluginCount, 2, 20, 10});
+  }
+
+  benchmark->Args({1000, 1, 20, 10});
+  benchmark->Args({1000, 8, 20, 10});
+  benchmark->Args({1000, 2, 5, 10});
+  benchmark->Args({1000, 2, 80, 10});
+  benchmark->Args({1000, 2, 20, 1});
+  benchmark->Args({1000, 2, 20, 100});
+
+  benchmark->Unit(::benchmark::kMillisecond);
+}
+}
+}
+
+#endif
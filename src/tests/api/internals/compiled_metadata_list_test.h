@@ -0,0 +1,228 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2014-2016    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_TESTS_API_INTERNALS_COMPILED_METADATA_LIST_TEST
+#define LOOT_TESTS_API_INTERNALS_COMPILED_METADATA_LIST_TEST
+
+#include "api/compiled_metadata_list.h"
+
+#include <fstream>
+#include <iterator>
+
+#include "api/metadata/yaml/plugin_metadata.h"
+#include "api/metadata_list.h"
+#include "tests/common_game_test_fixture.h"
+
+namespace loot {
+namespace test {
+class CompiledMetadataListTest : public CommonGameTestFixture {
+protected:
+  CompiledMetadataListTest() :
+      metadataPath(metadataFilesPath / "masterlist.yaml"),
+      compiledPath(metadataFilesPath / "masterlist.bin") {}
+
+  inline virtual void SetUp() {
+    CommonGameTestFixture::SetUp();
+
+    std::filesystem::copy(getSourceMetadataFilesPath() / "masterlist.yaml",
+                          metadataPath);
+    ASSERT_TRUE(std::filesystem::exists(metadataPath));
+    ASSERT_FALSE(std::filesystem::exists(compiledPath));
+  }
+
+  static MetadataSourceKey GetSourceKey(const std::filesystem::path& path) {
+    std::ifstream in(path);
+    return GetMetadataSourceKey(std::string(
+        std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()));
+  }
+
+  // PluginMetadata equality only compares names, so compare serialised
+  // metadata instead.
+  static std::string ToYaml(const std::optional<PluginMetadata>& metadata) {
+    if (!metadata.has_value()) {
+      return "";
+    }
+
+    YAML::Emitter emitter;
+    emitter << metadata.value();
+    return emitter.c_str();
+  }
+
+  static std::set<std::string> ToYaml(
+      const std::vector<PluginMetadata>& plugins) {
+    std::set<std::string> serialised;
+    for (const auto& plugin : plugins) {
+      serialised.insert(ToYaml(plugin));
+    }
+    return serialised;
+  }
+
+  const std::filesystem::path metadataPath;
+  const std::filesystem::path compiledPath;
+};
+
+// Pass an empty first argument, as it's a prefix for the test instantation,
+// but we only have the one so no prefix is necessary.
+INSTANTIATE_TEST_CASE_P(,
+                        CompiledMetadataListTest,
+                        ::testing::Values(GameType::tes4));
+
+TEST_P(CompiledMetadataListTest, loadShouldWriteACompiledListIfNoneExists) {
+  MetadataList metadataList;
+  ASSERT_NO_THROW(metadataList.Load(metadataPath, compiledPath));
+
+  EXPECT_TRUE(std::filesystem::exists(compiledPath));
+  EXPECT_TRUE(CompiledMetadataList::Open(compiledPath,
+                                         GetSourceKey(metadataPath)));
+}
+
+TEST_P(CompiledMetadataListTest,
+       loadingACompiledListShouldGiveTheSameMetadataAsParsingTheSource) {
+  MetadataList parsed;
+  ASSERT_NO_THROW(parsed.Load(metadataPath));
+
+  MetadataList compiled;
+  ASSERT_NO_THROW(compiled.Load(metadataPath, compiledPath));
+  ASSERT_NO_THROW(compiled.Load(metadataPath, compiledPath));
+
+  EXPECT_EQ(parsed.Messages(), compiled.Messages());
+  EXPECT_EQ(parsed.BashTags(), compiled.BashTags());
+  EXPECT_EQ(parsed.Groups(), compiled.Groups());
+  EXPECT_EQ(ToYaml(parsed.Plugins()), ToYaml(compiled.Plugins()));
+
+  for (const auto& name :
+       {blankEsm, blankEsp, blankDifferentEsp, blankMasterDependentEsp}) {
+    EXPECT_EQ(ToYaml(parsed.FindPlugin(name)),
+              ToYaml(compiled.FindPlugin(name)));
+  }
+}
+
+TEST_P(CompiledMetadataListTest, findPluginShouldBeCaseInsensitive) {
+  MetadataList metadataList;
+  ASSERT_NO_THROW(metadataList.Load(metadataPath, compiledPath));
+  ASSERT_NO_THROW(metadataList.Load(metadataPath, compiledPath));
+
+  auto plugin = metadataList.FindPlugin(boost::to_upper_copy(blankEsm));
+
+  ASSERT_TRUE(plugin.has_value());
+  EXPECT_EQ(blankEsm, plugin.value().GetName());
+}
+
+TEST_P(CompiledMetadataListTest,
+       findPluginShouldTrimAGhostExtensionFromTheGivenPluginName) {
+  MetadataList metadataList;
+  ASSERT_NO_THROW(metadataList.Load(metadataPath, compiledPath));
+  ASSERT_NO_THROW(metadataList.Load(metadataPath, compiledPath));
+
+  auto plugin = metadataList.FindPlugin(blankEsm + ".ghost");
+
+  ASSERT_TRUE(plugin.has_value());
+  EXPECT_EQ(blankEsm, plugin.value().GetName());
+}
+
+TEST_P(CompiledMetadataListTest,
+       openShouldReturnNullIfTheListWasCompiledFromDifferentContent) {
+  MetadataList metadataList;
+  ASSERT_NO_THROW(metadataList.Load(metadataPath, compiledPath));
+
+  auto sourceKey = GetSourceKey(metadataPath);
+  sourceKey.crc += 1;
+
+  EXPECT_FALSE(CompiledMetadataList::Open(compiledPath, sourceKey));
+}
+
+TEST_P(CompiledMetadataListTest,
+       openShouldReturnNullIfTheListWasWrittenWithADifferentFilenameKeyForm) {
+  MetadataList metadataList;
+  ASSERT_NO_THROW(metadataList.Load(metadataPath, compiledPath));
+
+  std::ifstream in(compiledPath, std::ios::binary);
+  std::string content((std::istreambuf_iterator<char>(in)),
+                      std::istreambuf_iterator<char>());
+  in.close();
+
+  // Swap the case of the key form's ASCII sample, as if the list had been
+  // written on a platform that normalises filenames differently.
+  auto keyFormPosition = content.find(GetFilenameKeyForm());
+  ASSERT_NE(std::string::npos, keyFormPosition);
+  content[keyFormPosition] ^= 0x20;
+
+  std::ofstream out(compiledPath, std::ios::binary);
+  out << content;
+  out.close();
+
+  EXPECT_FALSE(CompiledMetadataList::Open(compiledPath,
+                                          GetSourceKey(metadataPath)));
+}
+
+TEST_P(CompiledMetadataListTest, openShouldReturnNullIfTheListIsCorrupt) {
+  MetadataList metadataList;
+  ASSERT_NO_THROW(metadataList.Load(metadataPath, compiledPath));
+
+  std::fstream file(compiledPath,
+                    std::ios::in | std::ios::out | std::ios::binary);
+  file.seekp(-1, std::ios::end);
+  file.put('\xFF');
+  file.close();
+
+  EXPECT_FALSE(CompiledMetadataList::Open(compiledPath,
+                                          GetSourceKey(metadataPath)));
+}
+
+TEST_P(CompiledMetadataListTest,
+       loadShouldReplaceACompiledListThatIsOutOfDate) {
+  MetadataList metadataList;
+  ASSERT_NO_THROW(metadataList.Load(metadataPath, compiledPath));
+
+  std::ofstream out(metadataPath, std::ios::app);
+  out << std::endl << "bash_tags: [ C.Compiled ]" << std::endl;
+  out.close();
+
+  ASSERT_NO_THROW(metadataList.Load(metadataPath, compiledPath));
+
+  EXPECT_EQ(1, metadataList.BashTags().count("C.Compiled"));
+  EXPECT_TRUE(CompiledMetadataList::Open(compiledPath,
+                                         GetSourceKey(metadataPath)));
+}
+
+TEST_P(CompiledMetadataListTest,
+       addingAndErasingPluginsShouldKeepOtherCompiledPlugins) {
+  MetadataList metadataList;
+  ASSERT_NO_THROW(metadataList.Load(metadataPath, compiledPath));
+  ASSERT_NO_THROW(metadataList.Load(metadataPath, compiledPath));
+
+  auto plugin = metadataList.FindPlugin(blankEsp);
+  ASSERT_TRUE(plugin.has_value());
+
+  EXPECT_THROW(metadataList.AddPlugin(plugin.value()), std::invalid_argument);
+
+  metadataList.ErasePlugin(blankEsp);
+
+  EXPECT_FALSE(metadataList.FindPlugin(blankEsp));
+  EXPECT_TRUE(metadataList.FindPlugin(blankEsm));
+}
+}
+}
+
+#endif
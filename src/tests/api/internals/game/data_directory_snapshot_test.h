@@ -0,0 +1,152 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2014-2016    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_TESTS_API_INTERNALS_GAME_DATA_DIRECTORY_SNAPSHOT_TEST
+#define LOOT_TESTS_API_INTERNALS_GAME_DATA_DIRECTORY_SNAPSHOT_TEST
+
+#include "api/game/data_directory_snapshot.h"
+
+#include "tests/common_game_test_fixture.h"
+
+namespace loot {
+namespace test {
+class DataDirectorySnapshotTest : public CommonGameTestFixture {
+protected:
+  void touch(const std::string& filename) {
+    std::ofstream out(dataPath / filename);
+    out.close();
+  }
+};
+
+// Pass an empty first argument, as it's a prefix for the test instantation,
+// but we only have the one so no prefix is necessary.
+INSTANTIATE_TEST_CASE_P(,
+                        DataDirectorySnapshotTest,
+                        ::testing::Values(GameType::tes5));
+
+TEST_P(DataDirectorySnapshotTest, findPluginShouldReadThePluginFilesMetadata) {
+  DataDirectorySnapshot snapshot(dataPath, GetParam());
+
+  auto file = snapshot.FindPlugin(blankEsm);
+
+  ASSERT_TRUE(file.has_value());
+  EXPECT_EQ(blankEsm, file.value().name);
+  EXPECT_EQ(dataPath / blankEsm, file.value().path);
+  EXPECT_EQ(PluginDataCache::GetFileKey(dataPath / blankEsm),
+            file.value().key);
+}
+
+TEST_P(DataDirectorySnapshotTest,
+       findPluginShouldAddAGhostExtensionIfThePluginIsNotFound) {
+  DataDirectorySnapshot snapshot(dataPath, GetParam());
+
+  auto file = snapshot.FindPlugin(blankMasterDependentEsm);
+
+  ASSERT_TRUE(file.has_value());
+  EXPECT_EQ(blankMasterDependentEsm, file.value().name);
+  EXPECT_EQ(dataPath / (blankMasterDependentEsm + ".ghost"),
+            file.value().path);
+  EXPECT_TRUE(file.value().key.has_value());
+}
+
+TEST_P(DataDirectorySnapshotTest, findFileShouldNotAddAGhostExtension) {
+  DataDirectorySnapshot snapshot(dataPath, GetParam());
+
+  EXPECT_FALSE(snapshot.FindFile(blankMasterDependentEsm).has_value());
+}
+
+TEST_P(DataDirectorySnapshotTest,
+       findPluginShouldReturnNulloptIfThePluginDoesNotExist) {
+  DataDirectorySnapshot snapshot(dataPath, GetParam());
+
+  EXPECT_FALSE(snapshot.FindPlugin(missingEsp).has_value());
+}
+
+TEST_P(DataDirectorySnapshotTest,
+       findPluginShouldMatchANameThatDiffersOnlyInCaseAndKeepTheGivenName) {
+  DataDirectorySnapshot snapshot(dataPath, GetParam());
+
+  auto lowercaseName = boost::to_lower_copy(blankEsm);
+  auto file = snapshot.FindPlugin(lowercaseName);
+
+  ASSERT_TRUE(file.has_value());
+  EXPECT_EQ(lowercaseName, file.value().name);
+  EXPECT_EQ(dataPath / blankEsm, file.value().path);
+}
+
+#ifndef _WIN32
+TEST_P(DataDirectorySnapshotTest,
+       findFileShouldNotMatchCaseInsensitivelyIfMoreThanOneFileMatches) {
+  touch("ambiguous.txt");
+  touch("AMBIGUOUS.txt");
+  DataDirectorySnapshot snapshot(dataPath, GetParam());
+
+  EXPECT_TRUE(snapshot.FindFile("ambiguous.txt").has_value());
+  EXPECT_FALSE(snapshot.FindFile("Ambiguous.txt").has_value());
+}
+#endif
+
+TEST_P(DataDirectorySnapshotTest,
+       snapshotShouldNotReadMetadataForFilesWithoutPluginExtensions) {
+  touch("readme.txt");
+  DataDirectorySnapshot snapshot(dataPath, GetParam());
+
+  auto file = snapshot.FindFile("readme.txt");
+
+  ASSERT_TRUE(file.has_value());
+  EXPECT_FALSE(file.value().key.has_value());
+}
+
+TEST_P(DataDirectorySnapshotTest,
+       snapshotShouldNotSeeFilesAddedAfterItIsTaken) {
+  DataDirectorySnapshot snapshot(dataPath, GetParam());
+  touch("new.esp");
+
+  EXPECT_FALSE(snapshot.FindPlugin("new.esp").has_value());
+}
+
+TEST_P(DataDirectorySnapshotTest,
+       getPathsWithExtensionShouldCompareExtensionsCaseInsensitively) {
+  touch("Blank.BSA");
+  touch("Blank.esp.bsa.txt");
+  DataDirectorySnapshot snapshot(dataPath, GetParam());
+
+  auto paths = snapshot.GetPathsWithExtension(".bsa");
+
+  ASSERT_EQ(1, paths.size());
+  EXPECT_EQ(dataPath / "Blank.BSA", paths[0]);
+}
+
+TEST_P(DataDirectorySnapshotTest,
+       findPluginFileShouldAddAGhostExtensionIfThePathDoesNotExist) {
+  auto file = FindPluginFile(dataPath / blankMasterDependentEsm);
+
+  EXPECT_EQ(blankMasterDependentEsm, file.name);
+  EXPECT_EQ(dataPath / (blankMasterDependentEsm + ".ghost"), file.path);
+  EXPECT_TRUE(file.key.has_value());
+}
+}
+}
+
+#endif
@@ -28,6 +28,7 @@ along with LOOT.  If not, see
 #include "api/game/game_cache.h"
 
 #include "api/game/game.h"
+#include "api/helpers/text.h"
 #include "tests/common_game_test_fixture.h"
 
 namespace loot {
@@ -106,6 +107,87 @@ TEST_P(GameCacheTest,
   EXPECT_FALSE(cache_.GetPlugins().empty());
 }
 
+TEST_P(GameCacheTest,
+       gettingPluginsSnapshotShouldReturnTheSameSnapshotIfNothingChanged) {
+  cache_.AddPlugin(Plugin(game_.Type(),
+                          std::make_shared<GameCache>(GameCache()),
+                          game_.DataPath() / blankEsm,
+                          true));
+
+  EXPECT_EQ(cache_.GetPluginsSnapshot(), cache_.GetPluginsSnapshot());
+}
+
+TEST_P(GameCacheTest,
+       aPluginsSnapshotShouldNotChangeWhenTheCachedPluginsChange) {
+  cache_.AddPlugin(Plugin(game_.Type(),
+                          std::make_shared<GameCache>(GameCache()),
+                          game_.DataPath() / blankEsm,
+                          true));
+  auto snapshot = cache_.GetPluginsSnapshot();
+
+  cache_.AddPlugin(Plugin(game_.Type(),
+                          std::make_shared<GameCache>(GameCache()),
+                          game_.DataPath() / blankEsp,
+                          true));
+
+  ASSERT_EQ(1, snapshot->plugins.size());
+  EXPECT_EQ(blankEsm, (*snapshot->plugins.begin())->GetName());
+  EXPECT_EQ(1, snapshot->pluginsByName.count(FilenameKey(blankEsm)));
+
+  auto newSnapshot = cache_.GetPluginsSnapshot();
+  EXPECT_NE(snapshot, newSnapshot);
+  EXPECT_EQ(2, newSnapshot->plugins.size());
+  EXPECT_EQ(1, newSnapshot->pluginsByName.count(FilenameKey(blankEsp)));
+}
+
+TEST_P(GameCacheTest, settingPluginsShouldReplaceAllCachedPlugins) {
+  cache_.AddPlugin(Plugin(game_.Type(),
+                          std::make_shared<GameCache>(GameCache()),
+                          game_.DataPath() / blankEsm,
+                          true));
+  auto snapshot = cache_.GetPluginsSnapshot();
+
+  PluginsByName plugins;
+  for (const auto& name : {blankEsp, blankDifferentEsm}) {
+    auto plugin = std::make_shared<Plugin>(
+        game_.Type(),
+        std::make_shared<GameCache>(GameCache()),
+        game_.DataPath() / name,
+        true);
+    plugins.emplace(plugin->GetFilenameKey(), plugin);
+  }
+  cache_.SetPlugins(plugins);
+
+  EXPECT_EQ(1, snapshot->plugins.size());
+  EXPECT_FALSE(cache_.GetPlugin(blankEsm));
+  EXPECT_EQ(blankEsp, cache_.GetPlugin(blankEsp)->GetName());
+  EXPECT_EQ(blankDifferentEsm, cache_.GetPlugin(blankDifferentEsm)->GetName());
+  EXPECT_EQ(2, cache_.GetPluginsSnapshot()->plugins.size());
+}
+
+TEST_P(GameCacheTest, aPluginsSnapshotShouldBeSortedByFilename) {
+  cache_.AddPlugin(Plugin(game_.Type(),
+                          std::make_shared<GameCache>(GameCache()),
+                          game_.DataPath() / blankEsp,
+                          true));
+  cache_.AddPlugin(Plugin(game_.Type(),
+                          std::make_shared<GameCache>(GameCache()),
+                          game_.DataPath() / blankDifferentEsm,
+                          true));
+  cache_.AddPlugin(Plugin(game_.Type(),
+                          std::make_shared<GameCache>(GameCache()),
+                          game_.DataPath() / blankEsm,
+                          true));
+
+  std::vector<std::string> names;
+  for (const auto& plugin : cache_.GetPluginsSnapshot()->plugins) {
+    names.push_back(plugin->GetName());
+  }
+
+  EXPECT_EQ(std::vector<std::string>({blankDifferentEsm, blankEsm, blankEsp}),
+            names);
+}
+
 TEST_P(GameCacheTest,
   gettingArchivePathsShouldReturnAnEmptySetIfNoPathsHaveBeenCached) {
   EXPECT_TRUE(cache_.GetArchivePaths().empty());
@@ -124,6 +206,41 @@ TEST_P(GameCacheTest,
   EXPECT_EQ(expected, cache_.GetArchivePaths());
 }
 
+TEST_P(GameCacheTest, hasArchiveShouldReturnFalseIfNoPathsHaveBeenCached) {
+  EXPECT_FALSE(cache_.HasArchive("Blank.bsa"));
+}
+
+TEST_P(GameCacheTest, hasArchiveShouldCompareFilenamesCaseInsensitively) {
+  cache_.CacheArchivePath(game_.DataPath() / "Blank.bsa");
+
+  EXPECT_TRUE(cache_.HasArchive("Blank.bsa"));
+  EXPECT_TRUE(cache_.HasArchive("blank.BSA"));
+  EXPECT_FALSE(cache_.HasArchive("Blank"));
+  EXPECT_FALSE(cache_.HasArchive("Blank - Different.bsa"));
+}
+
+TEST_P(GameCacheTest,
+       hasArchiveWithPrefixShouldReturnTrueIfAnArchiveStartsWithThePrefix) {
+  cache_.CacheArchivePath(game_.DataPath() / "Blank - Different.bsa");
+  cache_.CacheArchivePath(game_.DataPath() / "Other.bsa");
+
+  EXPECT_TRUE(cache_.HasArchiveWithPrefix("Blank"));
+  EXPECT_TRUE(cache_.HasArchiveWithPrefix("blank - different"));
+  EXPECT_TRUE(cache_.HasArchiveWithPrefix("Blank - Different.bsa"));
+  EXPECT_TRUE(cache_.HasArchiveWithPrefix("Other"));
+  EXPECT_FALSE(cache_.HasArchiveWithPrefix("Blank - Different - Suffix"));
+  EXPECT_FALSE(cache_.HasArchiveWithPrefix("Blank.esm"));
+  EXPECT_FALSE(cache_.HasArchiveWithPrefix("Others"));
+}
+
+TEST_P(GameCacheTest, clearingCachedArchivePathsShouldClearTheArchiveIndex) {
+  cache_.CacheArchivePath(game_.DataPath() / "Blank.bsa");
+  cache_.ClearCachedArchivePaths();
+
+  EXPECT_FALSE(cache_.HasArchive("Blank.bsa"));
+  EXPECT_FALSE(cache_.HasArchiveWithPrefix("Blank"));
+}
+
 TEST_P(GameCacheTest, clearingCachedPluginsShouldNotThrowIfNoPluginsAreCached) {
   EXPECT_NO_THROW(cache_.ClearCachedPlugins());
 }
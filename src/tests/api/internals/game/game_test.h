@@ -27,6 +27,8 @@ along with LOOT.  If not, see
 
 #include "api/game/game.h"
 
+#include "loot/exception/operation_cancelled_error.h"
+
 #include "tests/common_game_test_fixture.h"
 
 namespace loot {
@@ -98,6 +100,36 @@ TEST_P(GameTest, constructingShouldNotThrowIfGameAndLocalPathsAreNotEmpty) {
   EXPECT_NO_THROW(Game(GetParam(), dataPath.parent_path(), localPath));
 }
 
+TEST_P(GameTest, getThreadCountShouldReturnAtLeastOneByDefault) {
+  Game game = Game(GetParam(), dataPath.parent_path(), localPath);
+
+  EXPECT_LE(1, game.GetThreadCount());
+}
+
+TEST_P(GameTest, getThreadCountShouldReturnTheCountSet) {
+  Game game = Game(GetParam(), dataPath.parent_path(), localPath);
+
+  game.SetThreadCount(3);
+  EXPECT_EQ(3, game.GetThreadCount());
+}
+
+TEST_P(GameTest, setThreadCountToZeroShouldRestoreTheDefaultThreadCount) {
+  Game game = Game(GetParam(), dataPath.parent_path(), localPath);
+  const auto defaultThreadCount = game.GetThreadCount();
+
+  game.SetThreadCount(3);
+  game.SetThreadCount(0);
+  EXPECT_EQ(defaultThreadCount, game.GetThreadCount());
+}
+
+TEST_P(GameTest, loadPluginsWithOneThreadShouldLoadAllInstalledPlugins) {
+  Game game = Game(GetParam(), dataPath.parent_path(), localPath);
+  game.SetThreadCount(1);
+
+  EXPECT_NO_THROW(loadInstalledPlugins(game, false));
+  EXPECT_EQ(11, game.GetCache()->GetPlugins().size());
+}
+
 TEST_P(
     GameTest,
     loadPluginsWithHeadersOnlyTrueShouldLoadTheHeadersOfAllInstalledPlugins) {
@@ -140,6 +172,214 @@ TEST_P(GameTest,
   ASSERT_TRUE(game.GetLoadedPlugins().empty());
 }
 
+TEST_P(GameTest,
+       loadPluginsShouldLoadAPluginThatIsOnlyFoundRelativeToTheDataPath) {
+  Game game = Game(GetParam(), dataPath.parent_path(), localPath);
+  const auto pluginName =
+      "../" + dataPath.filename().u8string() + "/" + blankEsm;
+
+  ASSERT_NO_THROW(game.LoadPlugins({pluginName}, true));
+
+  EXPECT_EQ(1, game.GetLoadedPlugins().size());
+}
+
+TEST_P(GameTest, tryLoadPluginsShouldReportAResultForEachPluginInOrder) {
+  Game game = Game(GetParam(), dataPath.parent_path(), localPath);
+
+  auto results = game.TryLoadPlugins({blankEsp, blankEsm}, false);
+
+  ASSERT_EQ(2, results.size());
+  EXPECT_EQ(blankEsp, results[0].name);
+  EXPECT_TRUE(results[0].is_loaded);
+  EXPECT_TRUE(results[0].error_message.empty());
+  EXPECT_EQ(blankEsm, results[1].name);
+  EXPECT_TRUE(results[1].is_loaded);
+  EXPECT_EQ(2, game.GetLoadedPlugins().size());
+}
+
+TEST_P(GameTest,
+       tryLoadPluginsShouldReportInvalidPluginsAndLoadTheValidPlugins) {
+  Game game = Game(GetParam(), dataPath.parent_path(), localPath);
+
+  auto results = game.TryLoadPlugins(
+      {nonPluginFile, blankEsm, missingEsp, "NotAPlugin.txt"}, false);
+
+  ASSERT_EQ(4, results.size());
+  EXPECT_FALSE(results[0].is_loaded);
+  EXPECT_FALSE(results[0].error_message.empty());
+  EXPECT_TRUE(results[1].is_loaded);
+  EXPECT_FALSE(results[2].is_loaded);
+  EXPECT_FALSE(results[2].error_message.empty());
+  EXPECT_FALSE(results[3].is_loaded);
+  EXPECT_FALSE(results[3].error_message.empty());
+
+  ASSERT_EQ(1, game.GetLoadedPlugins().size());
+  EXPECT_TRUE(game.GetPlugin(blankEsm));
+}
+
+TEST_P(GameTest, tryLoadPluginsShouldLoadGhostedPlugins) {
+  Game game = Game(GetParam(), dataPath.parent_path(), localPath);
+
+  auto results = game.TryLoadPlugins({blankMasterDependentEsm}, true);
+
+  ASSERT_EQ(1, results.size());
+  EXPECT_TRUE(results[0].is_loaded);
+  EXPECT_TRUE(game.GetPlugin(blankMasterDependentEsm));
+}
+
+TEST_P(GameTest, loadPluginsShouldReloadUnchangedPluginsByDefault) {
+  Game game = Game(GetParam(), dataPath.parent_path(), localPath);
+
+  game.LoadPlugins({blankEsm}, false);
+  auto plugin = game.GetCache()->GetPlugin(blankEsm);
+  game.LoadPlugins({blankEsm}, false);
+
+  EXPECT_NE(plugin, game.GetCache()->GetPlugin(blankEsm));
+}
+
+TEST_P(GameTest, incrementalLoadPluginsShouldKeepUnchangedPlugins) {
+  Game game = Game(GetParam(), dataPath.parent_path(), localPath);
+  game.SetIncrementalPluginLoading(true);
+
+  game.LoadPlugins({blankEsm, blankMasterDependentEsm}, false);
+  auto plugin = game.GetCache()->GetPlugin(blankEsm);
+  auto ghostedPlugin = game.GetCache()->GetPlugin(blankMasterDependentEsm);
+  game.LoadPlugins({blankEsm, blankMasterDependentEsm}, false);
+
+  EXPECT_EQ(plugin, game.GetCache()->GetPlugin(blankEsm));
+  EXPECT_EQ(ghostedPlugin,
+            game.GetCache()->GetPlugin(blankMasterDependentEsm));
+}
+
+TEST_P(GameTest, incrementalLoadPluginsShouldReloadModifiedPlugins) {
+  Game game = Game(GetParam(), dataPath.parent_path(), localPath);
+  game.SetIncrementalPluginLoading(true);
+
+  game.LoadPlugins({blankEsm, blankEsp}, false);
+  auto plugin = game.GetCache()->GetPlugin(blankEsm);
+  auto modifiedPlugin = game.GetCache()->GetPlugin(blankEsp);
+
+  auto modificationTime = std::filesystem::last_write_time(dataPath / blankEsp);
+  std::filesystem::last_write_time(dataPath / blankEsp,
+                                   modificationTime + std::chrono::seconds(1));
+  game.LoadPlugins({blankEsm, blankEsp}, false);
+
+  EXPECT_EQ(plugin, game.GetCache()->GetPlugin(blankEsm));
+  EXPECT_NE(modifiedPlugin, game.GetCache()->GetPlugin(blankEsp));
+  EXPECT_TRUE(game.GetCache()->GetPlugin(blankEsp));
+}
+
+TEST_P(GameTest,
+       incrementalLoadPluginsShouldReloadPluginsThatWereOnlyPartlyLoaded) {
+  Game game = Game(GetParam(), dataPath.parent_path(), localPath);
+  game.SetIncrementalPluginLoading(true);
+
+  game.LoadPlugins({blankEsm}, true);
+  EXPECT_FALSE(game.GetPlugin(blankEsm)->GetCRC().has_value());
+
+  game.LoadPlugins({blankEsm}, false);
+  EXPECT_EQ(blankEsmCrc, game.GetPlugin(blankEsm)->GetCRC().value());
+}
+
+TEST_P(GameTest, incrementalLoadPluginsShouldRemovePluginsThatAreNotGiven) {
+  Game game = Game(GetParam(), dataPath.parent_path(), localPath);
+  game.SetIncrementalPluginLoading(true);
+
+  game.LoadPlugins({blankEsm, blankEsp}, false);
+  game.LoadPlugins({blankEsm}, false);
+
+  ASSERT_EQ(1, game.GetLoadedPlugins().size());
+  EXPECT_TRUE(game.GetPlugin(blankEsm));
+}
+
+TEST_P(GameTest, incrementalTryLoadPluginsShouldRemovePluginsThatNoLongerLoad) {
+  Game game = Game(GetParam(), dataPath.parent_path(), localPath);
+  game.SetIncrementalPluginLoading(true);
+
+  game.TryLoadPlugins({blankEsm, blankEsp}, false);
+  std::filesystem::remove(dataPath / blankEsp);
+  auto results = game.TryLoadPlugins({blankEsm, blankEsp}, false);
+
+  EXPECT_TRUE(results[0].is_loaded);
+  EXPECT_FALSE(results[1].is_loaded);
+  ASSERT_EQ(1, game.GetLoadedPlugins().size());
+  EXPECT_TRUE(game.GetPlugin(blankEsm));
+}
+
+TEST_P(GameTest, loadPluginsAsyncShouldLoadTheGivenPlugins) {
+  Game game = Game(GetParam(), dataPath.parent_path(), localPath);
+
+  auto future =
+      game.LoadPluginsAsync({blankEsm, blankEsp}, false, nullptr, nullptr);
+  EXPECT_NO_THROW(future.get());
+
+  EXPECT_EQ(2, game.GetLoadedPlugins().size());
+  EXPECT_EQ(blankEsmCrc, game.GetPlugin(blankEsm)->GetCRC().value());
+}
+
+TEST_P(GameTest, loadPluginsAsyncShouldReportProgressForEachPlugin) {
+  Game game = Game(GetParam(), dataPath.parent_path(), localPath);
+
+  std::vector<OperationProgress> reports;
+  auto callback = [&](const OperationProgress& progress) {
+    reports.push_back(progress);
+  };
+
+  game.LoadPluginsAsync({blankEsm, blankEsp}, false, callback, nullptr).get();
+
+  ASSERT_EQ(3, reports.size());
+  EXPECT_EQ(0, reports.front().plugins_loaded);
+  EXPECT_EQ(2, reports.front().plugins_to_load);
+  EXPECT_EQ(2, reports.back().plugins_loaded);
+  EXPECT_EQ(reports.back().bytes_to_load, reports.back().bytes_loaded);
+  EXPECT_LT(0, reports.back().bytes_loaded);
+  for (const auto& report : reports) {
+    EXPECT_EQ(OperationPhase::load_plugins, report.phase);
+  }
+}
+
+TEST_P(GameTest, loadPluginsAsyncShouldThrowIfCancelled) {
+  Game game = Game(GetParam(), dataPath.parent_path(), localPath);
+
+  auto token = std::make_shared<CancellationToken>();
+  token->Cancel();
+
+  auto future = game.LoadPluginsAsync({blankEsm}, false, nullptr, token);
+  EXPECT_THROW(future.get(), OperationCancelledError);
+  EXPECT_TRUE(game.GetLoadedPlugins().empty());
+}
+
+TEST_P(GameTest, sortPluginsAsyncShouldGiveTheSameResultAsSortPlugins) {
+  Game game = Game(GetParam(), dataPath.parent_path(), localPath);
+  game.LoadCurrentLoadOrderState();
+  const std::vector<std::string> plugins({masterFile, blankEsm, blankEsp});
+
+  const auto expected = game.SortPlugins(plugins);
+
+  std::vector<OperationPhase> phases;
+  auto callback = [&](const OperationProgress& progress) {
+    if (phases.empty() || phases.back() != progress.phase) {
+      phases.push_back(progress.phase);
+    }
+  };
+
+  EXPECT_EQ(expected, game.SortPluginsAsync(plugins, callback, nullptr).get());
+  ASSERT_FALSE(phases.empty());
+  EXPECT_EQ(OperationPhase::load_plugins, phases.front());
+  EXPECT_EQ(OperationPhase::topological_sort, phases.back());
+}
+
+TEST_P(GameTest, sortPluginsAsyncShouldThrowIfCancelled) {
+  Game game = Game(GetParam(), dataPath.parent_path(), localPath);
+  game.LoadCurrentLoadOrderState();
+
+  auto token = std::make_shared<CancellationToken>();
+  token->Cancel();
+
+  auto future = game.SortPluginsAsync({masterFile, blankEsm}, nullptr, token);
+  EXPECT_THROW(future.get(), OperationCancelledError);
+}
+
 TEST_P(GameTest,
        loadPluginsWithHeadersOnlyFalseShouldFullyLoadAllInstalledPlugins) {
   Game game = Game(GetParam(), dataPath.parent_path(), localPath);
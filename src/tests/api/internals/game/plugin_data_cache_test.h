@@ -0,0 +1,246 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2014-2016    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_TESTS_API_INTERNALS_GAME_PLUGIN_DATA_CACHE_TEST
+#define LOOT_TESTS_API_INTERNALS_GAME_PLUGIN_DATA_CACHE_TEST
+
+#include "api/game/plugin_data_cache.h"
+
+#include "api/game/game.h"
+#include "loot/loot_version.h"
+#include "tests/common_game_test_fixture.h"
+
+namespace loot {
+namespace test {
+class PluginDataCacheTest : public CommonGameTestFixture {
+protected:
+  PluginDataCacheTest() :
+      cacheDirectory_(localPath / "plugin data cache"),
+      cacheFilePath_(cacheDirectory_ / "plugin_data_cache.txt"),
+      pluginPath_(dataPath / blankEsp) {}
+
+  void SetUp() override {
+    CommonGameTestFixture::SetUp();
+
+    // Data is not cached for recently-modified files, so move all the
+    // plugins' timestamps into the past, preserving their order.
+    for (const auto& entry : std::filesystem::directory_iterator(dataPath)) {
+      auto modificationTime = std::filesystem::last_write_time(entry.path());
+      std::filesystem::last_write_time(
+          entry.path(), modificationTime - std::chrono::hours(24));
+    }
+  }
+
+  PluginFileKey GetKey() const {
+    auto key = PluginDataCache::GetFileKey(pluginPath_);
+    EXPECT_TRUE(key.has_value());
+    return key.value();
+  }
+
+  const std::filesystem::path cacheDirectory_;
+  const std::filesystem::path cacheFilePath_;
+  const std::filesystem::path pluginPath_;
+};
+
+// Pass an empty first argument, as it's a prefix for the test instantation,
+// but we only have the one so no prefix is necessary.
+INSTANTIATE_TEST_CASE_P(,
+                        PluginDataCacheTest,
+                        ::testing::Values(GameType::tes3,
+                                          GameType::tes4,
+                                          GameType::fo4));
+
+TEST_P(PluginDataCacheTest,
+       getFileKeyShouldReturnNulloptIfTheFileDoesNotExist) {
+  EXPECT_FALSE(
+      PluginDataCache::GetFileKey(dataPath / missingEsp).has_value());
+}
+
+TEST_P(PluginDataCacheTest, getFileKeyShouldReturnTheFileSize) {
+  EXPECT_EQ(std::filesystem::file_size(pluginPath_), GetKey().size);
+}
+
+TEST_P(PluginDataCacheTest, findShouldReturnNulloptIfNothingHasBeenInserted) {
+  PluginDataCache cache(cacheDirectory_);
+
+  EXPECT_FALSE(cache.Find(pluginPath_, GetKey()).has_value());
+}
+
+TEST_P(PluginDataCacheTest, findShouldReturnInsertedDataIfTheKeyIsUnchanged) {
+  PluginDataCache cache(cacheDirectory_);
+  cache.Insert(pluginPath_, GetKey(), PluginFileData{0x12345678, 5});
+
+  auto data = cache.Find(pluginPath_, GetKey());
+
+  ASSERT_TRUE(data.has_value());
+  EXPECT_EQ(0x12345678, data.value().crc);
+  EXPECT_EQ(5, data.value().overrideRecordCount);
+}
+
+TEST_P(PluginDataCacheTest, findShouldReturnNulloptIfTheFileSizeHasChanged) {
+  PluginDataCache cache(cacheDirectory_);
+  auto key = GetKey();
+  cache.Insert(pluginPath_, key, PluginFileData{0x12345678, 5});
+
+  key.size += 1;
+
+  EXPECT_FALSE(cache.Find(pluginPath_, key).has_value());
+}
+
+TEST_P(PluginDataCacheTest,
+       findShouldReturnNulloptIfTheModificationTimeHasChanged) {
+  PluginDataCache cache(cacheDirectory_);
+  cache.Insert(pluginPath_, GetKey(), PluginFileData{0x12345678, 5});
+
+  auto modificationTime = std::filesystem::last_write_time(pluginPath_);
+  std::filesystem::last_write_time(pluginPath_,
+                                   modificationTime + std::chrono::seconds(1));
+
+  EXPECT_FALSE(cache.Find(pluginPath_, GetKey()).has_value());
+}
+
+TEST_P(PluginDataCacheTest, insertShouldIgnoreRecentlyModifiedFiles) {
+  PluginDataCache cache(cacheDirectory_);
+  std::filesystem::last_write_time(
+      pluginPath_, std::filesystem::file_time_type::clock::now());
+
+  cache.Insert(pluginPath_, GetKey(), PluginFileData{0x12345678, 5});
+
+  EXPECT_FALSE(cache.Find(pluginPath_, GetKey()).has_value());
+}
+
+TEST_P(PluginDataCacheTest, saveShouldNotWriteAFileIfNothingHasBeenInserted) {
+  PluginDataCache cache(cacheDirectory_);
+  cache.Save();
+
+  EXPECT_FALSE(std::filesystem::exists(cacheFilePath_));
+}
+
+TEST_P(PluginDataCacheTest, savedDataShouldBeReadByANewCache) {
+  PluginDataCache cache(cacheDirectory_);
+  cache.Insert(pluginPath_, GetKey(), PluginFileData{0x12345678, 5});
+  cache.Save();
+
+  PluginDataCache newCache(cacheDirectory_);
+  auto data = newCache.Find(pluginPath_, GetKey());
+
+  ASSERT_TRUE(data.has_value());
+  EXPECT_EQ(0x12345678, data.value().crc);
+  EXPECT_EQ(5, data.value().overrideRecordCount);
+}
+
+TEST_P(PluginDataCacheTest, aCorruptCacheFileShouldBeIgnored) {
+  PluginDataCache cache(cacheDirectory_);
+  cache.Insert(pluginPath_, GetKey(), PluginFileData{0x12345678, 5});
+  cache.Save();
+
+  std::string content;
+  {
+    std::ifstream in(cacheFilePath_, std::ios::binary);
+    content.assign(std::istreambuf_iterator<char>(in),
+                   std::istreambuf_iterator<char>());
+  }
+  content.back() = 'x';
+  std::ofstream(cacheFilePath_, std::ios::binary) << content;
+
+  PluginDataCache newCache(cacheDirectory_);
+
+  EXPECT_FALSE(newCache.Find(pluginPath_, GetKey()).has_value());
+}
+
+TEST_P(PluginDataCacheTest,
+       aCacheFileWrittenByADifferentVersionOfLibLootShouldBeIgnored) {
+  PluginDataCache cache(cacheDirectory_);
+  cache.Insert(pluginPath_, GetKey(), PluginFileData{0x12345678, 5});
+  cache.Save();
+
+  std::string content;
+  {
+    std::ifstream in(cacheFilePath_, std::ios::binary);
+    content.assign(std::istreambuf_iterator<char>(in),
+                   std::istreambuf_iterator<char>());
+  }
+  const auto versionLine = "libloot " + LootVersion::GetVersionString();
+  const auto versionPos = content.find(versionLine);
+  ASSERT_NE(std::string::npos, versionPos);
+  content.replace(versionPos, versionLine.size(), "libloot 0.0.0");
+  std::ofstream(cacheFilePath_, std::ios::binary) << content;
+
+  PluginDataCache newCache(cacheDirectory_);
+
+  EXPECT_FALSE(newCache.Find(pluginPath_, GetKey()).has_value());
+}
+
+TEST_P(PluginDataCacheTest,
+       loadPluginsShouldUseCachedDataForUnchangedPlugins) {
+  PluginDataCache cache(cacheDirectory_);
+  cache.Insert(pluginPath_, GetKey(), PluginFileData{0x12345678, 5});
+  cache.Save();
+
+  Game game(GetParam(), dataPath.parent_path(), localPath);
+  game.SetPluginDataCacheDirectory(cacheDirectory_);
+  game.LoadPlugins({blankEsp}, false);
+
+  auto plugin = game.GetCache()->GetPlugin(blankEsp);
+  ASSERT_NE(nullptr, plugin);
+  EXPECT_EQ(0x12345678, plugin->GetCRC().value());
+  EXPECT_EQ(5, plugin->NumOverrideFormIDs());
+}
+
+TEST_P(PluginDataCacheTest,
+       loadPluginsShouldNotUseCachedDataForChangedPlugins) {
+  PluginDataCache cache(cacheDirectory_);
+  auto key = GetKey();
+  key.size += 1;
+  cache.Insert(pluginPath_, key, PluginFileData{0x12345678, 5});
+  cache.Save();
+
+  Game game(GetParam(), dataPath.parent_path(), localPath);
+  game.SetPluginDataCacheDirectory(cacheDirectory_);
+  game.LoadPlugins({blankEsp}, false);
+
+  auto plugin = game.GetCache()->GetPlugin(blankEsp);
+  ASSERT_NE(nullptr, plugin);
+  EXPECT_NE(0x12345678, plugin->GetCRC().value());
+}
+
+TEST_P(PluginDataCacheTest,
+       loadPluginsWithACacheDirectoryShouldGiveTheSameResultAsWithout) {
+  Game game(GetParam(), dataPath.parent_path(), localPath);
+  game.LoadPlugins({blankEsm}, false);
+  auto crc = game.GetCache()->GetPlugin(blankEsm)->GetCRC();
+
+  game.SetPluginDataCacheDirectory(cacheDirectory_);
+  game.LoadPlugins({blankEsm}, false);
+  EXPECT_EQ(crc, game.GetCache()->GetPlugin(blankEsm)->GetCRC());
+  EXPECT_TRUE(std::filesystem::exists(cacheFilePath_));
+
+  game.LoadPlugins({blankEsm}, false);
+  EXPECT_EQ(crc, game.GetCache()->GetPlugin(blankEsm)->GetCRC());
+  EXPECT_EQ(blankEsmCrc, crc);
+}
+}
+}
+
+#endif
@@ -27,6 +27,10 @@ along with LOOT.  If not, see
 
 #include "api/helpers/crc.h"
 
+#include <random>
+
+#include <boost/crc.hpp>
+
 #include "loot/exception/file_access_error.h"
 #include "tests/common_game_test_fixture.h"
 
@@ -47,6 +51,84 @@ TEST_P(GetCrc32Test, gettingTheCrcOfAMissingFileShouldThrow) {
 TEST_P(GetCrc32Test, gettingTheCrcOfAFileShouldReturnTheCorrectValue) {
   EXPECT_EQ(blankEsmCrc, GetCrc32(dataPath / blankEsm));
 }
+
+TEST_P(GetCrc32Test, gettingTheCrcOfAnEmptyFileShouldReturnZero) {
+  std::ofstream out(dataPath / "empty.bin");
+  out.close();
+
+  EXPECT_EQ(0, GetCrc32(dataPath / "empty.bin"));
+}
+
+TEST_P(GetCrc32Test, gettingTheCrcOfALargeFileShouldMatchBoostCrc32) {
+  std::vector<char> bytes(3 * 1024 * 1024 + 7);
+  std::mt19937 generator(0);
+  for (auto& byte : bytes) {
+    byte = static_cast<char>(generator());
+  }
+
+  std::ofstream out(dataPath / "large.bin", std::ios::binary);
+  out.write(bytes.data(), bytes.size());
+  out.close();
+
+  boost::crc_32_type expected;
+  expected.process_bytes(bytes.data(), bytes.size());
+
+  EXPECT_EQ(expected.checksum(), GetCrc32(dataPath / "large.bin"));
+}
+
+class UpdateCrc32Test : public ::testing::Test {
+protected:
+  UpdateCrc32Test() : bytes_(1024 + 16) {
+    std::mt19937 generator(0);
+    for (auto& byte : bytes_) {
+      byte = static_cast<unsigned char>(generator());
+    }
+  }
+
+  uint32_t getBoostCrc32(size_t offset, size_t length) const {
+    boost::crc_32_type result;
+    result.process_bytes(bytes_.data() + offset, length);
+    return result.checksum();
+  }
+
+  std::vector<unsigned char> bytes_;
+};
+
+TEST_F(UpdateCrc32Test, shouldReturnTheStandardCheckValue) {
+  EXPECT_EQ(0xCBF43926, UpdateCrc32(0, "123456789", 9));
+  EXPECT_EQ(0xCBF43926, UpdateCrc32Portable(0, "123456789", 9));
+}
+
+TEST_F(UpdateCrc32Test, shouldReturnTheGivenCrcForEmptyData) {
+  EXPECT_EQ(0, UpdateCrc32(0, bytes_.data(), 0));
+  EXPECT_EQ(0x12345678, UpdateCrc32(0x12345678, bytes_.data(), 0));
+}
+
+TEST_F(UpdateCrc32Test,
+       shouldMatchBoostCrc32ForAllLengthsAndAlignmentsUpToOneKilobyte) {
+  for (size_t offset = 0; offset < 16; ++offset) {
+    for (size_t length = 0; length <= 1024; ++length) {
+      const auto expected = getBoostCrc32(offset, length);
+
+      ASSERT_EQ(expected, UpdateCrc32(0, bytes_.data() + offset, length))
+          << "offset " << offset << ", length " << length;
+      ASSERT_EQ(expected,
+                UpdateCrc32Portable(0, bytes_.data() + offset, length))
+          << "offset " << offset << ", length " << length;
+    }
+  }
+}
+
+TEST_F(UpdateCrc32Test, shouldGiveTheSameResultWhenDataIsSplitIntoBlocks) {
+  const auto expected = getBoostCrc32(0, bytes_.size());
+
+  for (size_t split = 0; split <= bytes_.size(); split += 13) {
+    auto crc = UpdateCrc32(0, bytes_.data(), split);
+    crc = UpdateCrc32(crc, bytes_.data() + split, bytes_.size() - split);
+
+    ASSERT_EQ(expected, crc) << "split at " << split;
+  }
+}
 }
 }
 
@@ -0,0 +1,131 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2014-2016    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_TESTS_API_INTERNALS_HELPERS_FILENAME_KEY_TEST
+#define LOOT_TESTS_API_INTERNALS_HELPERS_FILENAME_KEY_TEST
+
+#include "api/helpers/filename_key.h"
+
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "api/helpers/text.h"
+
+namespace loot {
+namespace test {
+TEST(FilenameKey, defaultConstructorShouldCreateTheKeyForAnEmptyFilename) {
+  EXPECT_EQ(FilenameKey(""), FilenameKey());
+  EXPECT_EQ("", FilenameKey().GetNormalizedName());
+}
+
+TEST(FilenameKey, keysForFilenamesThatDifferOnlyInCaseShouldBeEqual) {
+  FilenameKey key1("Blank.esm");
+  FilenameKey key2("blank.ESM");
+
+  EXPECT_EQ(key1, key2);
+  EXPECT_EQ(key1.GetId(), key2.GetId());
+  EXPECT_FALSE(key1 != key2);
+  EXPECT_FALSE(key1 < key2);
+  EXPECT_FALSE(key2 < key1);
+}
+
+TEST(FilenameKey, keysForDifferentFilenamesShouldNotBeEqual) {
+  FilenameKey key1("Blank.esm");
+  FilenameKey key2("Blank.esp");
+
+  EXPECT_NE(key1, key2);
+  EXPECT_NE(key1.GetId(), key2.GetId());
+  EXPECT_TRUE(key1 < key2 || key2 < key1);
+}
+
+TEST(FilenameKey, getNormalizedNameShouldReturnTheNormalizedFilename) {
+  FilenameKey key("Blank - Different.esm");
+
+  EXPECT_EQ(NormalizeFilename("Blank - Different.esm"),
+            key.GetNormalizedName());
+}
+
+TEST(FilenameKey, creatingAKeyForTheSameFilenameAgainShouldReuseItsId) {
+  auto id = FilenameKey("Blank.esm").GetId();
+
+  EXPECT_EQ(id, FilenameKey("BLANK.ESM").GetId());
+  EXPECT_EQ(id, FilenameKey("Blank.esm").GetId());
+}
+
+TEST(FilenameKey, hashShouldBeTheKeyId) {
+  FilenameKey key("Blank.esm");
+
+  EXPECT_EQ(key.GetId(), std::hash<FilenameKey>()(key));
+}
+
+TEST(FilenameKey, findShouldReturnTheKeyForAnyCaseOfAKnownFilename) {
+  FilenameKey key("Find Known.esm");
+
+  EXPECT_EQ(key, FilenameKey::Find("Find Known.esm"));
+  EXPECT_EQ(key, FilenameKey::Find("find known.ESM"));
+}
+
+TEST(FilenameKey, findShouldReturnNulloptForAFilenameWithNoKey) {
+  EXPECT_FALSE(FilenameKey::Find("Find Unknown.esm").has_value());
+
+  // Finding a filename doesn't create a key for it.
+  EXPECT_FALSE(FilenameKey::Find("Find Unknown.esm").has_value());
+}
+
+TEST(FilenameKey, keysCreatedConcurrentlyShouldBeConsistent) {
+  std::vector<std::string> filenames;
+  for (int i = 0; i < 100; i++) {
+    filenames.push_back("Concurrent " + std::to_string(i) + ".esp");
+  }
+
+  std::vector<std::vector<FilenameKey>> keys(4);
+  std::vector<std::thread> threads;
+  for (auto& threadKeys : keys) {
+    threads.emplace_back([&]() {
+      for (const auto& filename : filenames) {
+        threadKeys.push_back(FilenameKey(filename));
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::unordered_set<FilenameKey> uniqueKeys;
+  for (const auto& threadKeys : keys) {
+    ASSERT_EQ(filenames.size(), threadKeys.size());
+    EXPECT_EQ(keys[0], threadKeys);
+    uniqueKeys.insert(threadKeys.begin(), threadKeys.end());
+  }
+
+  EXPECT_EQ(filenames.size(), uniqueKeys.size());
+}
+}
+}
+
+#endif
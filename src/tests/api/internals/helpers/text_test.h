@@ -28,6 +28,10 @@ along with LOOT.  If not, see
 #include "api/helpers/text.h"
 #include "loot/loot_version.h"
 
+#include <random>
+#include <regex>
+
+#include <boost/algorithm/string.hpp>
 #include <gtest/gtest.h>
 
 namespace loot {
@@ -191,6 +195,120 @@ TEST(ExtractVersion, shouldExtractSingleDigitAfterVersionColonSpace) {
   EXPECT_EQ("2", ExtractVersion("Version: 2 {{BASH:C.Water}}").value());
 }
 
+TEST(ExtractVersion,
+     shouldExtractAShorterVersionIfTheLongestIsFollowedByAComma) {
+  EXPECT_EQ("1.2", ExtractVersion("v1.23, ").value());
+  EXPECT_EQ("1.2.3", ExtractVersion("v1.2.3a, ").value());
+  EXPECT_FALSE(ExtractVersion("Patch 1.2, and others").has_value());
+}
+
+// ExtractVersion() used to search for each version format using a regex, so
+// check that it gives the same results as those regexes.
+inline std::optional<std::string> ExtractVersionWithRegexes(
+    const std::string& text) {
+  const std::string pseudosemVersionRegex =
+      R"((\d+(?:\.\d+)+(?:[-._:]?[A-Za-z0-9]+)*))"
+      R"((?!,))";
+  static const std::vector<std::regex> versionRegexes({
+      std::regex(R"((\d{1,2}/\d{1,2}/\d{1,4} \d{1,2}:\d{1,2}:\d{1,2}))",
+                 std::regex::ECMAScript | std::regex::icase),
+      std::regex(R"(version:?\s)" + pseudosemVersionRegex,
+                 std::regex::ECMAScript | std::regex::icase),
+      std::regex(R"((?:^|v|\s))" + pseudosemVersionRegex,
+                 std::regex::ECMAScript | std::regex::icase),
+      std::regex(R"((?:^|v|version:\s*)(\d+))",
+                 std::regex::ECMAScript | std::regex::icase),
+  });
+
+  std::smatch what;
+  for (const auto& versionRegex : versionRegexes) {
+    if (std::regex_search(text, what, versionRegex)) {
+      for (auto it = next(begin(what)); it != end(what); ++it) {
+        if (it->str().empty())
+          continue;
+
+        std::string version = *it;
+        boost::trim(version);
+        return version;
+      }
+    }
+  }
+
+  return std::nullopt;
+}
+
+TEST(ExtractVersion, shouldGiveTheSameResultsAsRegexesForPluginDescriptions) {
+  const std::vector<std::string> descriptions({
+      "",
+      "5",
+      "10.11.12.13",
+      "1.0.0-x.7.z.92+exp.sha.5114f85",
+      "01.0.0_alpha:1-2 3",
+      "v5.0",
+      "The quick brown fox jumped over the lazy dog.",
+      "Updated: 10/09/2016 13:15:18\r\n\r\nRecords Changed: 43",
+      "Version 0.2.",
+      "Legendary Edition\r\n\r\nVersion: 3.0.0",
+      "fixing over 2,300 bugs so far! Version: 3.5.3",
+      "Version: 2.1 The Unofficial Fallout 3 Patch",
+      "V2.11\r\n\r\n{{BASH:Invent}}",
+      "Version:. 1.09",
+      "comprehensive bugfixing mod for The Elder Scrolls V: "
+      "Skyrim\r\n\r\nVersion: 2.1.3b\r\n\r\n",
+      "SkyUI 5.1",
+      "Adds 8 variants of Triss Merigold's outfit from \"The Witcher 2\"",
+      "Requires Skyrim patch 1.9.32.0.8 or greater.\n"
+      "Requires Unofficial Skyrim Legendary Edition Patch 3.0.0 or greater.\n"
+      "Version 2.0.0",
+      "Immersive Armors v8 Main Plugin",
+      "Compatibility patch for AOS v2.5 and True Storms v1.5 (or "
+      "later),\nPatch Version: 1.0",
+      "Version: 2 {{BASH:C.Water}}",
+      "Unofficial Skyrim Special Edition Patch\n\nA comprehensive bugfixing "
+      "mod for The Elder Scrolls V: Skyrim - Special Edition\n\nVersion: "
+      "4.1.4\n\nRequires Skyrim Special Edition 1.5.39 or greater.\n\n"
+      "{{BASH:C.Climate,C.Encounter,C.ImageSpace,C.Light,C.Location,"
+      "C.SkyLighting,Delev,Graphics,Invent,Names,Relev,Sound,Stats}}",
+      "Version: 1.3.0.35\r\nMade by someone, 12/1/2012 9:04:5",
+      "version:\t2a",
+      "VERSION:   17 - the final release",
+      "Patch for v1.2,v1.3 and v1.4b.",
+      "Compiled 2/29/2020 23:59:59, version 2.3-beta",
+      "Adds 3 new spells. Requires 1.6.640.",
+      "v.1.2 v1..2 v1.-2 v1.2-.3 v1.2:3_b",
+  });
+
+  for (const auto& description : descriptions) {
+    EXPECT_EQ(ExtractVersionWithRegexes(description),
+              ExtractVersion(description))
+        << "Description: " << description;
+  }
+}
+
+TEST(ExtractVersion, shouldGiveTheSameResultsAsRegexesForGeneratedText) {
+  // Build strings out of the fragments that the version formats are made of,
+  // so that near misses are common.
+  const std::vector<std::string> fragments({
+      "0", "1", "12", "123", "2016", ".", ",", "-", "_", ":", "/", " ", "\t",
+      "v", "V", "a", "Z", "x", "+", "(", "}}", "\xC3", "Ver", "Version",
+      "version:", "VERSION: ",
+  });
+
+  std::mt19937 generator(0);
+  std::uniform_int_distribution<size_t> fragmentCount(1, 12);
+  std::uniform_int_distribution<size_t> fragmentIndex(0, fragments.size() - 1);
+
+  for (int i = 0; i < 20000; ++i) {
+    std::string text;
+    for (size_t j = fragmentCount(generator); j > 0; --j) {
+      text += fragments[fragmentIndex(generator)];
+    }
+
+    ASSERT_EQ(ExtractVersionWithRegexes(text), ExtractVersion(text))
+        << "Text: " << text;
+  }
+}
+
 // MSVC interprets source files in the default code page, so
 // for me u8"\xC3\x9C" != u8"\u00DC", which is a lot of fun.
 // To avoid insanity, write non-ASCII characters as \uXXXX escapes.
@@ -329,6 +447,67 @@ TEST(NormalizeFilename, shouldCaseFoldStringsAndBeLocaleInvariant) {
   std::locale::global(std::locale::classic());
 }
 #endif
+
+// ASCII filenames are handled without converting them to UTF-16, so check
+// that gives the same results as the Unicode path, which is used if a
+// filename contains any non-ASCII characters.
+// \u00e9 is 'é'
+// \u212a is the kelvin sign 'K'
+
+TEST(CompareFilenames, shouldOrderAsciiCharactersTheSameAsUnicodeFilenames) {
+  for (int i = 1; i < 128; ++i) {
+    for (int j = 1; j < 128; ++j) {
+      const std::string lhs(1, static_cast<char>(i));
+      const std::string rhs(1, static_cast<char>(j));
+
+      EXPECT_EQ(CompareFilenames(lhs + u8"\u00e9", rhs + u8"\u00e9"),
+                CompareFilenames(lhs, rhs))
+          << "Characters: " << i << ", " << j;
+    }
+  }
+}
+
+TEST(CompareFilenames, shouldCompareLongAsciiFilenamesCaseInsensitively) {
+  const std::string filename =
+      "Unofficial Skyrim Special Edition Patch - Part 2.esp";
+
+  EXPECT_EQ(0, CompareFilenames(filename, boost::to_upper_copy(filename)));
+  EXPECT_EQ(0, CompareFilenames(boost::to_lower_copy(filename), filename));
+  EXPECT_EQ(-1,
+            CompareFilenames("Unofficial Skyrim Special Edition Patch - A",
+                             "unofficial skyrim special edition patch - b"));
+  EXPECT_EQ(1,
+            CompareFilenames("Unofficial Skyrim Special Edition Patch.esp",
+                             "unofficial skyrim special edition patch"));
+  EXPECT_EQ(-1,
+            CompareFilenames("Unofficial Skyrim Special Edition",
+                             "unofficial skyrim special edition patch"));
+}
+
+#ifndef _WIN32
+TEST(CompareFilenames, shouldUseUnicodeCaseFoldingIfAFilenameIsNotAscii) {
+  EXPECT_EQ(0, CompareFilenames(u8"\u212a.esp", "k.esp"));
+  EXPECT_EQ(0, CompareFilenames("K.esp", u8"\u212a.esp"));
+}
+#endif
+
+TEST(NormalizeFilename,
+     shouldNormalizeAsciiCharactersTheSameAsUnicodeFilenames) {
+  const auto normalizedSuffix = NormalizeFilename(u8"\u00e9");
+
+  for (int i = 1; i < 128; ++i) {
+    const std::string filename(1, static_cast<char>(i));
+
+    EXPECT_EQ(NormalizeFilename(filename) + normalizedSuffix,
+              NormalizeFilename(filename + u8"\u00e9"))
+        << "Character: " << i;
+  }
+
+  const std::string filename =
+      "Unofficial Skyrim Special Edition Patch - Part 2.esp";
+  EXPECT_EQ(NormalizeFilename(filename) + normalizedSuffix,
+            NormalizeFilename(filename + u8"\u00e9"));
+}
 }
 }
 
@@ -0,0 +1,124 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2014-2016    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_TESTS_API_INTERNALS_HELPERS_THREAD_POOL_TEST
+#define LOOT_TESTS_API_INTERNALS_HELPERS_THREAD_POOL_TEST
+
+#include "api/helpers/thread_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+
+namespace loot {
+namespace test {
+TEST(ThreadPool, constructorShouldCreateAtLeastOneThread) {
+  ThreadPool pool(0);
+
+  EXPECT_EQ(1, pool.ThreadCount());
+}
+
+TEST(ThreadPool, runShouldRunEveryTaskOnce) {
+  ThreadPool pool(4);
+
+  std::vector<std::atomic<int>> counts(100);
+  std::vector<std::function<void()>> tasks;
+  for (size_t i = 0; i < counts.size(); ++i) {
+    tasks.push_back([&counts, i]() { counts[i]++; });
+  }
+
+  pool.Run(tasks);
+
+  for (const auto& count : counts) {
+    EXPECT_EQ(1, count);
+  }
+}
+
+TEST(ThreadPool, runShouldDoNothingIfThereAreNoTasks) {
+  ThreadPool pool(2);
+
+  EXPECT_NO_THROW(pool.Run({}));
+}
+
+TEST(ThreadPool, runShouldBeAbleToBeCalledRepeatedly) {
+  ThreadPool pool(3);
+
+  std::atomic<int> count(0);
+  for (int i = 0; i < 10; ++i) {
+    pool.Run({[&]() { count++; }, [&]() { count++; }});
+  }
+
+  EXPECT_EQ(20, count);
+}
+
+TEST(ThreadPool, runShouldRethrowAnExceptionAfterAllTasksHaveFinished) {
+  ThreadPool pool(2);
+
+  std::atomic<int> count(0);
+  std::vector<std::function<void()>> tasks(
+      {[]() { throw std::runtime_error("error"); }});
+  for (int i = 0; i < 10; ++i) {
+    tasks.push_back([&]() { count++; });
+  }
+
+  EXPECT_THROW(pool.Run(tasks), std::runtime_error);
+  EXPECT_EQ(10, count);
+
+  EXPECT_NO_THROW(pool.Run({[&]() { count++; }}));
+  EXPECT_EQ(11, count);
+}
+
+TEST(ThreadPool, runShouldThrowIfCalledFromATaskThatThePoolIsRunning) {
+  ThreadPool pool(2);
+
+  std::vector<std::function<void()>> tasks(
+      {[&]() { pool.Run({[]() {}}); }});
+
+  EXPECT_THROW(pool.Run(tasks), std::logic_error);
+}
+
+TEST(ThreadPool, idleThreadsShouldStealTasksFromBusyThreads) {
+  ThreadPool pool(2);
+
+  // The first task is dealt to the first thread, which blocks until all the
+  // other tasks have run. Half of those are dealt to the first thread too, so
+  // they must be stolen by the second thread for the first task to finish.
+  std::atomic<int> count(0);
+  std::vector<std::function<void()>> tasks({[&]() {
+    while (count < 9) {
+      std::this_thread::yield();
+    }
+  }});
+  for (int i = 0; i < 9; ++i) {
+    tasks.push_back([&]() { count++; });
+  }
+
+  pool.Run(tasks);
+
+  EXPECT_EQ(9, count);
+}
+}
+}
+
+#endif
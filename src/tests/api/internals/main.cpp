@@ -22,12 +22,17 @@
     <https://www.gnu.org/licenses/>.
     */
 
+#include "tests/api/internals/compiled_metadata_list_test.h"
+#include "tests/api/internals/game/data_directory_snapshot_test.h"
 #include "tests/api/internals/game/game_cache_test.h"
 #include "tests/api/internals/game/game_test.h"
 #include "tests/api/internals/game/load_order_handler_test.h"
+#include "tests/api/internals/game/plugin_data_cache_test.h"
 #include "tests/api/internals/helpers/crc_test.h"
+#include "tests/api/internals/helpers/filename_key_test.h"
 #include "tests/api/internals/helpers/git_helper_test.h"
 #include "tests/api/internals/helpers/text_test.h"
+#include "tests/api/internals/helpers/thread_pool_test.h"
 #include "tests/api/internals/helpers/yaml_set_helpers_test.h"
 #include "tests/api/internals/masterlist_test.h"
 #include "tests/api/internals/metadata/condition_evaluator_test.h"
@@ -45,6 +50,7 @@
 #include "tests/api/internals/sorting/group_sort_test.h"
 #include "tests/api/internals/sorting/plugin_graph_test.h"
 #include "tests/api/internals/sorting/plugin_sort_test.h"
+#include "tests/api/internals/sorting/plugin_sort_cache_test.h"
 #include "tests/api/internals/sorting/plugin_sorting_data_test.h"
 
 TEST(ModuloOperator, shouldConformToTheCpp11Standard) {
@@ -27,6 +27,10 @@ along with LOOT.  If not, see
 
 #include "api/metadata_list.h"
 
+#include <fstream>
+
+#include <yaml-cpp/yaml.h>
+
 #include "tests/common_game_test_fixture.h"
 
 namespace loot {
@@ -176,6 +180,19 @@ TEST_P(MetadataListTest, loadShouldThrowIfAnInvalidMetadataFileIsGiven) {
   }
 }
 
+TEST_P(MetadataListTest, loadShouldThrowIfARegexPluginNameIsInvalid) {
+  const auto path = metadataFilesPath / "invalid_regex.yaml";
+  std::ofstream out(path);
+  out << "plugins:" << std::endl
+      << "  - name: 'Blank(.esp|'" << std::endl
+      << "    group: group1" << std::endl;
+  out.close();
+
+  MetadataList metadataList;
+
+  EXPECT_THROW(metadataList.Load(path), YAML::RepresentationException);
+}
+
 TEST_P(MetadataListTest,
        loadShouldClearExistingDataIfAnInvalidMetadataFileIsGiven) {
   MetadataList metadataList;
@@ -305,6 +322,17 @@ TEST_P(
             plugin.GetIncompatibilities());
 }
 
+TEST_P(MetadataListTest,
+       findPluginShouldTrimAGhostExtensionFromTheGivenPluginName) {
+  MetadataList metadataList;
+  ASSERT_NO_THROW(metadataList.Load(metadataPath));
+
+  auto plugin = metadataList.FindPlugin(blankDifferentEsp + ".ghost");
+
+  ASSERT_TRUE(plugin.has_value());
+  EXPECT_EQ(blankDifferentEsp, plugin.value().GetName());
+}
+
 TEST_P(MetadataListTest, addPluginShouldStoreGivenSpecificPluginMetadata) {
   MetadataList metadataList;
   ASSERT_NO_THROW(metadataList.Load(metadataPath));
@@ -334,6 +362,53 @@ TEST_P(MetadataListTest, addPluginShouldStoreGivenRegexPluginMetadata) {
   EXPECT_EQ("group1", plugin.GetGroup());
 }
 
+TEST_P(MetadataListTest,
+       findPluginShouldMatchRegexEntriesCaseInsensitivelyAndMergeThem) {
+  MetadataList metadataList;
+
+  PluginMetadata plugin("blank.+\\.esp");
+  plugin.SetGroup("group1");
+  metadataList.AddPlugin(plugin);
+
+  plugin = PluginMetadata("Blank - Different.*");
+  plugin.SetLoadAfterFiles({File(blankEsm)});
+  metadataList.AddPlugin(plugin);
+
+  plugin = PluginMetadata("Different.+\\.esp");
+  plugin.SetLoadAfterFiles({File(blankDifferentEsm)});
+  metadataList.AddPlugin(plugin);
+
+  plugin = metadataList.FindPlugin(blankDifferentEsp).value();
+
+  EXPECT_EQ(blankDifferentEsp, plugin.GetName());
+  EXPECT_EQ("group1", plugin.GetGroup());
+  EXPECT_EQ(std::set<File>({File(blankEsm)}), plugin.GetLoadAfterFiles());
+
+  EXPECT_FALSE(metadataList.FindPlugin(blankEsm));
+}
+
+TEST_P(MetadataListTest,
+       findPluginShouldTrimAGhostExtensionBeforeMatchingRegexEntries) {
+  MetadataList metadataList;
+
+  PluginMetadata plugin("blank.+\\.esp");
+  plugin.SetGroup("group1");
+  metadataList.AddPlugin(plugin);
+
+  auto match = metadataList.FindPlugin(blankDifferentEsp + ".ghost");
+
+  ASSERT_TRUE(match.has_value());
+  EXPECT_EQ(blankDifferentEsp, match.value().GetName());
+  EXPECT_EQ("group1", match.value().GetGroup());
+}
+
+TEST_P(MetadataListTest, addPluginShouldThrowIfARegexPluginNameIsInvalid) {
+  MetadataList metadataList;
+
+  EXPECT_THROW(metadataList.AddPlugin(PluginMetadata("Blank(.esp|")),
+               std::invalid_argument);
+}
+
 TEST_P(MetadataListTest, addPluginShouldThrowIfAMatchingPluginAlreadyExists) {
   MetadataList metadataList;
   ASSERT_NO_THROW(metadataList.Load(metadataPath));
@@ -359,6 +434,17 @@ TEST_P(MetadataListTest,
   EXPECT_FALSE(metadataList.FindPlugin(plugin.GetName()));
 }
 
+TEST_P(MetadataListTest,
+       erasePluginShouldTrimAGhostExtensionFromTheGivenPluginName) {
+  MetadataList metadataList;
+  ASSERT_NO_THROW(metadataList.Load(metadataPath));
+  ASSERT_TRUE(metadataList.FindPlugin(blankEsp));
+
+  metadataList.ErasePlugin(blankEsp + ".ghost");
+
+  EXPECT_FALSE(metadataList.FindPlugin(blankEsp));
+}
+
 TEST_P(
     MetadataListTest,
     evalAllConditionsShouldEvaluateTheConditionsForThePluginsStoredInTheMetadataList) {
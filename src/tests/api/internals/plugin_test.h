@@ -279,6 +279,22 @@ TEST_P(PluginTest, loadingAPluginWithMastersShouldReadThemCorrectly) {
   EXPECT_EQ(std::vector<std::string>({blankEsm}), plugin.GetMasters());
 }
 
+TEST_P(PluginTest, getHeaderShouldReturnTheSameDataAsTheHeaderAccessors) {
+  Plugin plugin(game_.Type(),
+                game_.GetCache(),
+                game_.DataPath() / blankMasterDependentEsp,
+                false);
+
+  auto& header = plugin.GetHeader();
+
+  EXPECT_EQ(plugin.GetMasters(), header.masters);
+  EXPECT_EQ(plugin.GetVersion(), header.version);
+  EXPECT_EQ(plugin.GetHeaderVersion(), header.headerVersion.value());
+  EXPECT_EQ(plugin.IsMaster(), header.isMaster);
+  EXPECT_EQ(plugin.IsLightMaster(), header.isLightMaster);
+  EXPECT_EQ(plugin.IsValidAsLightMaster(), header.isValidAsLightMaster);
+}
+
 TEST_P(PluginTest, loadingAPluginThatDoesNotExistShouldThrow) {
   EXPECT_THROW(Plugin(game_.Type(),
                       game_.GetCache(),
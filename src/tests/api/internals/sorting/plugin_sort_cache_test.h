@@ -0,0 +1,143 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2014-2016    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_TESTS_API_INTERNALS_SORTING_PLUGIN_SORT_CACHE_TEST
+#define LOOT_TESTS_API_INTERNALS_SORTING_PLUGIN_SORT_CACHE_TEST
+
+#include "api/sorting/plugin_sort_cache.h"
+
+#include "tests/common_game_test_fixture.h"
+
+namespace loot {
+namespace test {
+class PluginSortCacheTest : public CommonGameTestFixture {
+protected:
+  PluginSortCacheTest() :
+      game_(GetParam(), dataPath.parent_path(), localPath),
+      cachePath_(localPath / "sort_cache.txt") {}
+
+  void SetUp() override {
+    CommonGameTestFixture::SetUp();
+
+    game_.IdentifyMainMasterFile(masterFile);
+    game_.LoadCurrentLoadOrderState();
+    game_.LoadPlugins(game_.GetLoadOrder(), false);
+  }
+
+  Game game_;
+  const std::filesystem::path cachePath_;
+};
+
+// Pass an empty first argument, as it's a prefix for the test instantation,
+// but we only have the one so no prefix is necessary.
+INSTANTIATE_TEST_CASE_P(,
+                        PluginSortCacheTest,
+                        ::testing::Values(GameType::tes3,
+                                          GameType::tes4,
+                                          GameType::fo4));
+
+TEST_P(PluginSortCacheTest,
+       sortFingerprintShouldBeTheSameForUnchangedInputs) {
+  auto loadOrder = game_.GetLoadOrder();
+
+  EXPECT_EQ(GetSortFingerprint(game_, loadOrder),
+            GetSortFingerprint(game_, loadOrder));
+}
+
+TEST_P(PluginSortCacheTest,
+       sortFingerprintShouldChangeIfTheLoadOrderChanges) {
+  auto loadOrder = game_.GetLoadOrder();
+  auto fingerprint = GetSortFingerprint(game_, loadOrder);
+
+  std::swap(loadOrder[1], loadOrder[2]);
+
+  EXPECT_NE(fingerprint, GetSortFingerprint(game_, loadOrder));
+}
+
+TEST_P(PluginSortCacheTest,
+       sortFingerprintShouldChangeIfAPluginsUserMetadataChanges) {
+  auto loadOrder = game_.GetLoadOrder();
+  auto fingerprint = GetSortFingerprint(game_, loadOrder);
+
+  PluginMetadata plugin(blankEsp);
+  plugin.SetLoadAfterFiles({File(blankDifferentEsp)});
+  game_.GetDatabase()->SetPluginUserMetadata(plugin);
+
+  EXPECT_NE(fingerprint, GetSortFingerprint(game_, loadOrder));
+}
+
+TEST_P(PluginSortCacheTest,
+       readCachedSortResultShouldReturnNulloptIfTheCacheFileDoesNotExist) {
+  EXPECT_FALSE(ReadCachedSortResult(cachePath_, "fingerprint").has_value());
+}
+
+TEST_P(PluginSortCacheTest,
+       readCachedSortResultShouldReturnNulloptIfTheFingerprintDoesNotMatch) {
+  WriteCachedSortResult(cachePath_, "fingerprint", game_.GetLoadOrder());
+
+  EXPECT_FALSE(ReadCachedSortResult(cachePath_, "other").has_value());
+}
+
+TEST_P(
+    PluginSortCacheTest,
+    readCachedSortResultShouldReturnTheWrittenResultIfTheFingerprintMatches) {
+  auto loadOrder = game_.GetLoadOrder();
+  WriteCachedSortResult(cachePath_, "fingerprint", loadOrder);
+
+  auto cachedResult = ReadCachedSortResult(cachePath_, "fingerprint");
+
+  ASSERT_TRUE(cachedResult.has_value());
+  EXPECT_EQ(loadOrder, cachedResult.value());
+}
+
+TEST_P(PluginSortCacheTest,
+       sortPluginsWithACachePathShouldGiveTheSameResultAsWithout) {
+  auto loadOrder = game_.GetLoadOrder();
+  auto sorted = game_.SortPlugins(loadOrder);
+
+  game_.SetSortCachePath(cachePath_);
+
+  EXPECT_EQ(sorted, game_.SortPlugins(loadOrder));
+  EXPECT_TRUE(std::filesystem::exists(cachePath_));
+
+  EXPECT_EQ(sorted, game_.SortPlugins(loadOrder));
+}
+
+TEST_P(PluginSortCacheTest,
+       sortPluginsShouldRecordWhetherTheCachedResultWasUsed) {
+  auto loadOrder = game_.GetLoadOrder();
+  game_.SetSortCachePath(cachePath_);
+
+  game_.SortPlugins(loadOrder);
+  EXPECT_FALSE(game_.GetSortStatistics().used_cached_result);
+  EXPECT_LT(0, game_.GetSortStatistics().vertex_count);
+
+  game_.SortPlugins(loadOrder);
+  EXPECT_TRUE(game_.GetSortStatistics().used_cached_result);
+  EXPECT_EQ(0, game_.GetSortStatistics().vertex_count);
+}
+}
+}
+
+#endif
@@ -95,6 +95,18 @@ protected:
     masterlist.close();
   }
 
+  // Sorts using the compatibility engine, and checks that the priority engine
+  // gives the same result.
+  std::vector<std::string> sortWithBothEngines(Game &game) {
+    game.SetSortingEngine(SortingEngine::compatibility);
+    auto sorted = SortPlugins(game, game.GetLoadOrder());
+
+    game.SetSortingEngine(SortingEngine::priority);
+    EXPECT_EQ(sorted, SortPlugins(game, game.GetLoadOrder()));
+
+    return sorted;
+  }
+
   std::string getCCCFilename() {
     if (GetParam() == GameType::fo4) {
       return "Fallout4.ccc";
@@ -132,7 +144,7 @@ INSTANTIATE_TEST_CASE_P(,
                                           GameType::fo4));
 
 TEST_P(PluginSortTest, sortingWithNoLoadedPluginsShouldReturnAnEmptyList) {
-  std::vector<std::string> sorted = SortPlugins(game_, game_.GetLoadOrder());
+  std::vector<std::string> sorted = sortWithBothEngines(game_);
 
   EXPECT_TRUE(sorted.empty());
 }
@@ -145,11 +157,92 @@ TEST_P(PluginSortTest,
 
   // Check stability by running the sort 100 times.
   for (int i = 0; i < 100; i++) {
-    std::vector<std::string> sorted = SortPlugins(game_, game_.GetLoadOrder());
+    std::vector<std::string> sorted = sortWithBothEngines(game_);
     ASSERT_EQ(expectedSortedOrder, sorted) << " for sort " << i;
   }
 }
 
+TEST_P(PluginSortTest, sortingShouldGiveTheSameResultForAnyThreadCount) {
+  ASSERT_NO_THROW(loadInstalledPlugins(game_, false));
+
+  game_.SetThreadCount(1);
+  std::vector<std::string> expectedSortedOrder = sortWithBothEngines(game_);
+
+  for (size_t threadCount = 2; threadCount < 5; threadCount++) {
+    game_.SetThreadCount(threadCount);
+    std::vector<std::string> sorted = sortWithBothEngines(game_);
+    EXPECT_EQ(expectedSortedOrder, sorted) << " for " << threadCount
+                                           << " threads";
+  }
+}
+
+TEST_P(PluginSortTest, sortingShouldRecordGraphStatistics) {
+  ASSERT_NO_THROW(loadInstalledPlugins(game_, false));
+
+  SortStatistics statistics;
+  SortPlugins(game_, game_.GetLoadOrder(), statistics);
+
+  EXPECT_LE(game_.GetCache()->GetPlugins().size(), statistics.vertex_count);
+  EXPECT_LT(0, statistics.edges_added[EdgeType::master]);
+  EXPECT_LT(0, statistics.edges_added[EdgeType::tieBreak]);
+  EXPECT_LT(0, statistics.cycle_checks);
+
+  size_t edgeCount = 0;
+  for (const auto& edges : statistics.edges_added) {
+    edgeCount += edges.second;
+  }
+  EXPECT_EQ(statistics.edge_count, edgeCount);
+}
+
+TEST_P(PluginSortTest,
+       sortingWithThePriorityEngineShouldNotRecordAnyTieBreakEdges) {
+  ASSERT_NO_THROW(loadInstalledPlugins(game_, false));
+
+  game_.SetSortingEngine(SortingEngine::priority);
+  SortStatistics statistics;
+  SortPlugins(game_, game_.GetLoadOrder(), statistics);
+
+  EXPECT_EQ(0, statistics.edges_added.count(EdgeType::tieBreak));
+  EXPECT_EQ(std::chrono::microseconds(0),
+            statistics.add_tie_break_edges_duration);
+}
+
+TEST_P(PluginSortTest,
+       theSortingEnginesShouldDisagreeIfATieBreakWouldHaveOverriddenPriority) {
+  // The plugins are given in filename order, which is the order in which the
+  // compatibility engine adds tie-break edges, and they're also in load order.
+  // The metadata makes the last plugin load before the first.
+  game_.IdentifyMainMasterFile(masterFile);
+  game_.LoadCurrentLoadOrderState();
+  game_.LoadPlugins(
+      {blankDifferentEsp, blankMasterDependentEsp, blankPluginDependentEsp},
+      true);
+
+  PluginMetadata plugin(blankDifferentEsp);
+  plugin.SetLoadAfterFiles({File(blankPluginDependentEsp)});
+  game_.GetDatabase()->SetPluginUserMetadata(plugin);
+
+  // The first tie-break edge puts the first plugin before the second, so the
+  // third plugin must move in front of both.
+  game_.SetSortingEngine(SortingEngine::compatibility);
+  EXPECT_EQ(std::vector<std::string>({
+                blankPluginDependentEsp,
+                blankDifferentEsp,
+                blankMasterDependentEsp,
+            }),
+            SortPlugins(game_, game_.GetLoadOrder()));
+
+  // The second plugin has the highest priority of those that can load first,
+  // so it keeps its place ahead of the third plugin.
+  game_.SetSortingEngine(SortingEngine::priority);
+  EXPECT_EQ(std::vector<std::string>({
+                blankMasterDependentEsp,
+                blankPluginDependentEsp,
+                blankDifferentEsp,
+            }),
+            SortPlugins(game_, game_.GetLoadOrder()));
+}
+
 TEST_P(PluginSortTest, sortingShouldResolveGroupsAsTransitiveLoadAfterSets) {
   ASSERT_NO_THROW(loadInstalledPlugins(game_, false));
 
@@ -182,7 +275,7 @@ TEST_P(PluginSortTest, sortingShouldResolveGroupsAsTransitiveLoadAfterSets) {
     expectedSortedOrder.insert(expectedSortedOrder.begin() + 5, blankEsl);
   }
 
-  std::vector<std::string> sorted = SortPlugins(game_, game_.GetLoadOrder());
+  std::vector<std::string> sorted = sortWithBothEngines(game_);
   EXPECT_EQ(expectedSortedOrder, sorted);
 }
 
@@ -225,7 +318,7 @@ TEST_P(PluginSortTest,
     expectedSortedOrder.insert(expectedSortedOrder.begin() + 3, blankEsl);
   }
 
-  std::vector<std::string> sorted = SortPlugins(game_, game_.GetLoadOrder());
+  std::vector<std::string> sorted = sortWithBothEngines(game_);
   EXPECT_EQ(expectedSortedOrder, sorted);
 }
 
@@ -269,7 +362,7 @@ TEST_P(
     expectedSortedOrder.insert(expectedSortedOrder.begin() + 5, blankEsl);
   }
 
-  std::vector<std::string> sorted = SortPlugins(game_, game_.GetLoadOrder());
+  std::vector<std::string> sorted = sortWithBothEngines(game_);
   EXPECT_EQ(expectedSortedOrder, sorted);
 }
 
@@ -309,7 +402,7 @@ TEST_P(
     expectedSortedOrder.insert(expectedSortedOrder.begin() + 3, masterFile);
   }
 
-  std::vector<std::string> sorted = SortPlugins(game_, game_.GetLoadOrder());
+  std::vector<std::string> sorted = sortWithBothEngines(game_);
   EXPECT_EQ(expectedSortedOrder, sorted);
 }
 
@@ -384,7 +477,7 @@ TEST_P(
     expectedSortedOrder.insert(expectedSortedOrder.begin() + 1, masterFile);
   }
 
-  std::vector<std::string> sorted = SortPlugins(game_, game_.GetLoadOrder());
+  std::vector<std::string> sorted = sortWithBothEngines(game_);
   EXPECT_EQ(expectedSortedOrder, sorted);
 }
 
@@ -422,7 +515,7 @@ TEST_P(
     expectedSortedOrder.insert(expectedSortedOrder.begin() + 2, blankEsl);
   }
 
-  std::vector<std::string> sorted = SortPlugins(game_, game_.GetLoadOrder());
+  std::vector<std::string> sorted = sortWithBothEngines(game_);
   EXPECT_EQ(expectedSortedOrder, sorted);
 }
 
@@ -454,7 +547,7 @@ TEST_P(PluginSortTest,
     expectedSortedOrder.insert(expectedSortedOrder.begin() + 5, blankEsl);
   }
 
-  std::vector<std::string> sorted = SortPlugins(game_, game_.GetLoadOrder());
+  std::vector<std::string> sorted = sortWithBothEngines(game_);
   EXPECT_EQ(expectedSortedOrder, sorted);
 }
 
@@ -486,7 +579,7 @@ TEST_P(PluginSortTest,
     expectedSortedOrder.insert(expectedSortedOrder.begin() + 5, blankEsl);
   }
 
-  std::vector<std::string> sorted = SortPlugins(game_, game_.GetLoadOrder());
+  std::vector<std::string> sorted = sortWithBothEngines(game_);
   EXPECT_EQ(expectedSortedOrder, sorted);
 }
 
@@ -517,8 +610,7 @@ TEST_P(PluginSortTest,
       blankDifferentPluginDependentEsp,
   });
 
-  std::vector<std::string> sorted =
-      SortPlugins(newGame, newGame.GetLoadOrder());
+  std::vector<std::string> sorted = sortWithBothEngines(newGame);
   EXPECT_EQ(expectedSortedOrder, sorted);
 }
 
@@ -531,6 +623,19 @@ TEST_P(PluginSortTest, sortingShouldThrowIfACyclicInteractionIsEncountered) {
   EXPECT_THROW(SortPlugins(game_, game_.GetLoadOrder()),
                CyclicInteractionError);
 }
+
+TEST_P(
+    PluginSortTest,
+    sortingWithThePriorityEngineShouldThrowIfACyclicInteractionIsEncountered) {
+  ASSERT_NO_THROW(loadInstalledPlugins(game_, false));
+  PluginMetadata plugin(blankEsm);
+  plugin.SetLoadAfterFiles({File(blankMasterDependentEsm)});
+  game_.GetDatabase()->SetPluginUserMetadata(plugin);
+
+  game_.SetSortingEngine(SortingEngine::priority);
+  EXPECT_THROW(SortPlugins(game_, game_.GetLoadOrder()),
+               CyclicInteractionError);
+}
 }
 }
 
@@ -90,7 +90,7 @@ TEST_P(PluginSortingDataTest,
       *dynamic_cast<const Plugin *>(game_.GetPlugin(blankEsp).get()),
       PluginMetadata(),
       PluginMetadata(),
-      getLoadOrder(),
+      GetLoadOrderIndexes(getLoadOrder()),
       game_.Type(),
       game_.GetCache()->GetPlugins());
   EXPECT_FALSE(esp.IsMaster());
@@ -99,7 +99,7 @@ TEST_P(PluginSortingDataTest,
       *dynamic_cast<const Plugin *>(game_.GetPlugin(blankEsm).get()),
       PluginMetadata(),
       PluginMetadata(),
-      getLoadOrder(),
+      GetLoadOrderIndexes(getLoadOrder()),
       game_.Type(),
       game_.GetCache()->GetPlugins());
   EXPECT_TRUE(master.IsMaster());
@@ -109,7 +109,7 @@ TEST_P(PluginSortingDataTest,
         *dynamic_cast<const Plugin *>(game_.GetPlugin(blankEsl).get()),
         PluginMetadata(),
         PluginMetadata(),
-        getLoadOrder(),
+        GetLoadOrderIndexes(getLoadOrder()),
         game_.Type(),
         game_.GetCache()->GetPlugins());
     EXPECT_TRUE(lightMaster.IsMaster());
@@ -118,7 +118,7 @@ TEST_P(PluginSortingDataTest,
         *dynamic_cast<const Plugin *>(game_.GetPlugin(blankEslEsp).get()),
         PluginMetadata(),
         PluginMetadata(),
-        getLoadOrder(),
+        GetLoadOrderIndexes(getLoadOrder()),
         game_.Type(),
         game_.GetCache()->GetPlugins());
     EXPECT_FALSE(lightMasterEsp.IsMaster());
@@ -134,7 +134,7 @@ TEST_P(PluginSortingDataTest,
                             game_.GetPlugin(blankMasterDependentEsm).get()),
                         PluginMetadata(),
                         PluginMetadata(),
-                        getLoadOrder(),
+                        GetLoadOrderIndexes(getLoadOrder()),
                         game_.Type(),
                         game_.GetCache()->GetPlugins());
   EXPECT_EQ(4, plugin.NumOverrideFormIDs());
@@ -163,7 +163,7 @@ TEST_P(PluginSortingDataTest,
                             game_.GetPlugin(blankMasterDependentEsm).get()),
                         PluginMetadata(),
                         PluginMetadata(),
-                        getLoadOrder(),
+                        GetLoadOrderIndexes(getLoadOrder()),
                         game_.Type(),
                         loadedPlugins);
 